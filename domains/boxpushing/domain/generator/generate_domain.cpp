@@ -0,0 +1,104 @@
+
+#include <cstring>
+
+#include "../../../generator/Generator.h"
+
+using namespace generator;
+
+static void printActions( std::ostream & f, int maxBoxSize, bool singleAgent ) {
+	if ( singleAgent ) {
+		f << "(:action move\n";
+		f << "\t:parameters (?a - agent ?x - location ?y - location)\n";
+		f << "\t:precondition (and (at ?a ?x) (connected ?x ?y))\n";
+		f << "\t:effect\t(and (at ?a ?y) (not (at ?a ?x)))\n";
+		f << ")\n";
+
+		for ( int i = 1; i <= maxBoxSize; ++i ) {
+			f << "(:action push-bsize" << i << "\n";
+
+			f << "\t:parameters (";
+			for ( int j = 1; j <= i; ++j )
+				f << "?a" << j << " - agent ?b" << j << " - bsize" << i << " ?x" << j << " ?y" << j << " - location ";
+			f << ")\n";
+
+			f << "\t:precondition (and\n";
+			for ( int j = 1; j <= i; ++j ) {
+				f << "\t\t(at ?a" << j << " ?x" << j << ") (at ?b" << j << " ?x" << j << ") (connected ?x" << j << " ?y" << j << ")\n";
+				if ( j > 1 )
+					f << "\t\t(not (= ?a" << j - 1 << " ?a" << j << ")) (= ?b" << j - 1 << " ?b" << j << ") (= ?x" << j - 1 << " ?x" << j << ") (= ?y" << j - 1 << " ?y" << j << ")\n";
+			}
+			f << "\t)\n";
+
+			f << "\t:effect (and\n";
+			for ( int j = 1; j <= i; ++j )
+				f << "\t\t(at ?a" << j << " ?y" << j << ") (at ?b" << j << " ?y" << j << ") (not (at ?a" << j << " ?x" << j << ")) (not (at ?b" << j << " ?x" << j << "))\n";
+			f << "\t)\n";
+
+			f << ")\n";
+		}
+	}
+	else {
+		f << "(:action move\n";
+		f << "\t:agent ?a - agent\n";
+		f << "\t:parameters (?x - location ?y - location)\n";
+		f << "\t:precondition (and (at ?a ?x) (connected ?x ?y))\n";
+		f << "\t:effect\t(and (at ?a ?y) (not (at ?a ?x)))\n";
+		f << ")\n";
+
+		for ( int i = 1; i <= maxBoxSize; ++i ) {
+			f << "(:action push-bsize" << i << "\n";
+			f << "\t:agent ?a - agent\n";
+			f << "\t:parameters (?b - bsize" << i << " ?x - location ?y - location)\n";
+			f << "\t:precondition (and (at ?a ?x) (at ?b ?x) (connected ?x ?y)";
+
+			if ( i > 1 ) {
+				f << " (exists (";
+				for ( int j = 2; j <= i; ++j ) f << "?a" << j << " - agent ";
+				f << ") (and ";
+				for ( int j = 2; j <= i; ++j )
+					for ( int k = j + 1; k <= i; ++k )
+						f << "(not (= ?a" << j << " ?a" << k << "))";
+				for ( int j = 2; j <= i; ++j )
+					f << "(not (= ?a ?a" << j << ")) (push-bsize" << i << " ?a" << j << " ?b ?x ?y) ";
+				f << "))";
+			}
+			f << ")\n";
+
+			f << "\t:effect\t(and (at ?a ?y) (at ?b ?y) (not (at ?a ?x)) (not (at ?b ?x))))\n";
+		}
+	}
+}
+
+int main( int argc, char * argv[] ) {
+	if ( argc < 2 ) {
+		std::cout << "Usage: generate_boxpushing_domain <size> [-s|--single-agent]\n";
+		std::exit( 0 );
+	}
+
+	int maxBoxSize = intArg( argv[1] );
+	bool singleAgent = argc > 2 && ( !strcmp( argv[2], "-s" ) || !strcmp( argv[2], "--single-agent" ) );
+
+	std::ostringstream os;
+	os << "domain" << maxBoxSize << ".pddl";
+	std::ofstream f( os.str().c_str() );
+
+	f << "(define (domain boxpushing)\n";
+	f << "(:requirements :typing";
+	if ( !singleAgent ) f << " :multi-agent";
+	f << ")\n";
+
+	f << "(:types box agent - locatable";
+	for ( int i = 1; i <= maxBoxSize; ++i ) f << " bsize" << i;
+	f << " - box";
+	f << " location)\n";
+
+	f << "(:predicates\n";
+	f << "\t(at ?l - locatable ?x - location)\n";
+	f << "\t(connected ?x - location ?y - location)\n";
+	f << ")\n";
+
+	printActions( f, maxBoxSize, singleAgent );
+
+	f << ")\n";
+	f.close();
+}
@@ -0,0 +1,92 @@
+
+#include <map>
+
+#include "../../../generator/Generator.h"
+
+using namespace generator;
+
+typedef std::map< std::string, std::pair< int, int > > LocMap;
+
+static void printObjects( std::ostream & f, const char * type, const char * prefix, int n ) {
+	if ( n > 0 ) {
+		f << "\t";
+		for ( int o = 1; o <= n; ++o ) f << prefix << o << " ";
+		f << "- " << type << "\n";
+	}
+}
+
+static void printInit( std::ostream & f, const char * prefix, int n, int rows, int columns, Random & rnd, LocMap & locs ) {
+	for ( int o = 1; o <= n; ++o ) {
+		std::ostringstream os;
+		os << prefix << o;
+		int r = rnd.range( 1, rows ), c = rnd.range( 1, columns );
+		f << "\t(at " << os.str() << " r" << r << "x" << c << ")\n";
+		locs[os.str()] = std::make_pair( r, c );
+	}
+}
+
+static void printGoal( std::ostream & f, const char * prefix, int n, int rows, int columns, Random & rnd, LocMap & locs ) {
+	for ( int o = 1; o <= n; ++o ) {
+		std::ostringstream os;
+		os << prefix << o;
+		std::pair< int, int > p;
+		do p = std::make_pair( rnd.range( 1, rows ), rnd.range( 1, columns ) );
+		while ( p == locs[os.str()] );
+		f << "\t(at " << os.str() << " r" << p.first << "x" << p.second << ")\n";
+	}
+}
+
+int main( int argc, char * argv[] ) {
+	if ( argc < 7 ) {
+		std::cout << "Usage: generate_boxpushing <rows> <columns> <agents> <small> <medium> <large> [seed]\n";
+		std::exit( 0 );
+	}
+
+	int rows = intArg( argv[1] ), columns = intArg( argv[2] ), agents = intArg( argv[3] );
+	int small = intArg( argv[4] ), medium = intArg( argv[5] ), large = intArg( argv[6] );
+	if ( rows < 1 || columns < 1 ) fail( "The grid needs at least one cell" );
+	if ( rows * columns < 2 && small + medium + large > 0 ) fail( "Boxes need at least two cells to be moved" );
+
+	Random rnd( seedArg( argc, argv, 7 ) );
+
+	std::ostringstream name;
+	name << "p" << rows << "_" << columns << "_" << agents << "_" << small << "_" << medium << "_" << large;
+
+	std::ofstream f( ( name.str() + ".pddl" ).c_str() );
+	f << "(define (problem " << name.str() << ") (:domain boxpushing)\n";
+
+	f << "(:objects\n";
+	printObjects( f, "agent", "a", agents );
+	printObjects( f, "smallbox", "s", small );
+	printObjects( f, "mediumbox", "m", medium );
+	printObjects( f, "largebox", "l", large );
+	f << "\t";
+	for ( int r = 1; r <= rows; ++r )
+		for ( int c = 1; c <= columns; ++c )
+			f << "r" << r << "x" << c << " ";
+	f << "- location\n";
+	f << ")\n";
+
+	LocMap locs;
+	f << "(:init\n";
+	printInit( f, "a", agents, rows, columns, rnd, locs );
+	printInit( f, "s", small, rows, columns, rnd, locs );
+	printInit( f, "m", medium, rows, columns, rnd, locs );
+	printInit( f, "l", large, rows, columns, rnd, locs );
+	for ( int r = 1; r <= rows; ++r )
+		for ( int c = 1; c <= columns; ++c ) {
+			if ( r > 1 ) f << "\t(connected r" << r << "x" << c << " r" << r - 1 << "x" << c << ")\n";
+			if ( r < rows ) f << "\t(connected r" << r << "x" << c << " r" << r + 1 << "x" << c << ")\n";
+			if ( c > 1 ) f << "\t(connected r" << r << "x" << c << " r" << r << "x" << c - 1 << ")\n";
+			if ( c < columns ) f << "\t(connected r" << r << "x" << c << " r" << r << "x" << c + 1 << ")\n";
+		}
+	f << ")\n";
+
+	f << "(:goal (and\n";
+	printGoal( f, "s", small, rows, columns, rnd, locs );
+	printGoal( f, "m", medium, rows, columns, rnd, locs );
+	printGoal( f, "l", large, rows, columns, rnd, locs );
+	f << "))\n";
+	f << ")\n";
+	f.close();
+}
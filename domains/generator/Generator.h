@@ -0,0 +1,133 @@
+
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+// Helpers shared by the native instance generators of the bundled domains.
+// The random number generator is a plain splitmix64 and all draws go through
+// our own rejection sampling, so a given seed produces the same instance on
+// every platform and standard library (std::uniform_int_distribution does not
+// give that guarantee).
+
+namespace generator {
+
+class Random
+{
+public:
+	explicit Random( std::uint64_t seed ) : state( seed ) {}
+
+	std::uint64_t next()
+	{
+		std::uint64_t z = ( state += 0x9E3779B97F4A7C15ull );
+		z = ( z ^ ( z >> 30 ) ) * 0xBF58476D1CE4E5B9ull;
+		z = ( z ^ ( z >> 27 ) ) * 0x94D049BB133111EBull;
+		return z ^ ( z >> 31 );
+	}
+
+	// uniform integer in [0, n)
+	unsigned uniform( unsigned n )
+	{
+		if ( n < 2 ) return 0;
+		std::uint64_t limit = UINT64_MAX - UINT64_MAX % n;
+		std::uint64_t r;
+		do r = next(); while ( r >= limit );
+		return unsigned( r % n );
+	}
+
+	// uniform integer in [lo, hi]
+	int range( int lo, int hi )
+	{
+		return lo + int( uniform( unsigned( hi - lo + 1 ) ) );
+	}
+
+private:
+	std::uint64_t state;
+};
+
+typedef std::pair< unsigned, unsigned > Edge;
+typedef std::vector< Edge > EdgeVec;
+
+inline void fail( const std::string & msg )
+{
+	std::cerr << msg << "\n";
+	std::exit( 1 );
+}
+
+// Random connected undirected graph with n nodes and e edges: a spanning tree
+// built by a random walk followed by random extra edges (the same scheme as the
+// random_walk function of the former Python generators). Edges are returned in
+// creation order, each one oriented from the node already in the tree.
+inline EdgeVec randomConnectedGraph( unsigned n, unsigned e, Random & rnd )
+{
+	if ( n == 0 ) return EdgeVec();
+	if ( e + 1 < n ) fail( "Number of edges less than minimum (nodes - 1)" );
+	if ( std::uint64_t( e ) > std::uint64_t( n ) * ( n - 1 ) / 2 ) fail( "Number of edges greater than maximum (nodes * (nodes - 1) / 2)" );
+
+	EdgeVec edges;
+	edges.reserve( e );
+	std::unordered_set< std::uint64_t > edgeSet;
+	edgeSet.reserve( 2 * e );
+
+	auto key = [n]( unsigned a, unsigned b ) {
+		if ( a > b ) std::swap( a, b );
+		return std::uint64_t( a ) * n + b;
+	};
+
+	std::vector< bool > visited( n, false );
+	unsigned current = rnd.uniform( n ), left = n - 1;
+	visited[current] = true;
+	while ( left ) {
+		unsigned neighbor = rnd.uniform( n );
+		if ( !visited[neighbor] ) {
+			edges.emplace_back( current, neighbor );
+			edgeSet.insert( key( current, neighbor ) );
+			visited[neighbor] = true;
+			--left;
+		}
+		current = neighbor;
+	}
+
+	while ( edges.size() < e ) {
+		unsigned a = rnd.uniform( n ), b = rnd.uniform( n );
+		if ( a != b && edgeSet.insert( key( a, b ) ).second )
+			edges.emplace_back( a, b );
+	}
+
+	return edges;
+}
+
+inline int intArg( const char * s )
+{
+	std::istringstream is( s );
+	int i = 0;
+	if ( !( is >> i ) || i < 0 ) fail( std::string( "Invalid numeric argument '" ) + s + "'" );
+	return i;
+}
+
+// optional trailing seed argument, defaults to 1
+inline std::uint64_t seedArg( int argc, char * argv[], int pos )
+{
+	if ( argc <= pos ) return 1;
+	std::istringstream is( argv[pos] );
+	std::uint64_t seed = 1;
+	if ( !( is >> seed ) ) fail( std::string( "Invalid seed '" ) + argv[pos] + "'" );
+	return seed;
+}
+
+inline bool boolArg( const std::string & s )
+{
+	if ( s == "yes" || s == "true" || s == "t" || s == "y" || s == "1" ) return true;
+	if ( s == "no" || s == "false" || s == "f" || s == "n" || s == "0" ) return false;
+	fail( "Boolean value expected instead of '" + s + "'" );
+	return false;
+}
+
+} // namespace generator
@@ -1,24 +1,21 @@
 
-#include <cstdlib>
-#include <fstream>
-#include <iostream>
 #include <map>
-#include <sstream>
-#include <vector>
+
+#include "../../../generator/Generator.h"
 
 #define PARS 10
 
 enum Passage { DOOR, BRIDGE, BOAT, SWITCH };
 
-Passage randomPassage( int * pars, int total ) {
-	int i = 0, s = pars[0], r = rand() % total;
+Passage randomPassage( generator::Random & rnd, int * pars, int total ) {
+	int i = 0, s = pars[0], r = rnd.uniform( total );
 	while ( s <= r ) s += pars[++i];
 	return Passage( i );
 }
 
 int main( int argc, char * argv[] ) {
 	if ( argc < PARS ) {
-		std::cout << "Usage: generate <agents> <iter> <lo> <hi> <step> <door> <bridge> <boat> <switch>\n";
+		std::cout << "Usage: generate <agents> <iter> <lo> <hi> <step> <door> <bridge> <boat> <switch> [seed]\n";
 		std::exit( 0 );
 	}
 
@@ -29,6 +26,8 @@ int main( int argc, char * argv[] ) {
 		if ( i >= 6 ) total += pars[i];
 	}
 
+	generator::Random rnd( generator::seedArg( argc, argv, PARS ) );
+
 	for ( int i = pars[3]; i <= pars[4]; i += pars[5] )
 		for ( int j = 1; j <= pars[2]; ++j ) {
 			int types[4] = { 0, 0, 0, 0 }, indices[4] = { 0, 0, 0, 0 };
@@ -39,13 +38,13 @@ int main( int argc, char * argv[] ) {
 				PMap h;
 				int x = k / i, y = k % i;
 				if ( x + 1 < i ) {
-					Passage p = randomPassage( pars + 6, total );
+					Passage p = randomPassage( rnd, pars + 6, total );
 					types[p]++;
 					if ( p == 3 ) types[0]++;
 					h[( x + 1 )*i + y] = p;
 				}
 				if ( y + 1 < i ) {
-					Passage p = randomPassage( pars + 6, total );
+					Passage p = randomPassage( rnd, pars + 6, total );
 					types[p]++;
 					if ( p == 3 ) types[0]++;
 					h[x*i + y + 1] = p;
@@ -72,7 +71,7 @@ int main( int argc, char * argv[] ) {
 			for ( int k = 1; k <= types[3]; ++k ) f << "s" << k << " ";
 			f << "- switch\n)\n(:init\n";
 			for ( int k = 1; k <= pars[1]; ++k ) {
-				int r = rand() % ( i * i );
+				int r = rnd.uniform( i * i );
 				f << "\t(at a" << k << " loc" << r/i + 1 << "x" << r%i + 1 << ")\n";
 			}
 			for ( IPMap::iterator k = m.begin(); k != m.end(); ++k )
@@ -101,7 +100,7 @@ int main( int argc, char * argv[] ) {
 							break;
 						}
 						case SWITCH: {
-							int r = rand() % ( i * i );
+							int r = rnd.uniform( i * i );
 							f << "\t(has-door d" << ++indices[0];
 							f << " loc" << x1 << "x" << y1 << " loc" << x2 << "x" << y2 << ")\n";
 							f << "\t(has-door d" << indices[0];
@@ -116,7 +115,7 @@ int main( int argc, char * argv[] ) {
 				}
 			f << ")\n(:goal (and\n";
 			for ( int k = 1; k <= pars[1]; ++k ) {
-				int r = rand() % ( i * i );
+				int r = rnd.uniform( i * i );
 				f << "\t(at a" << k << " loc" << r/i + 1 << "x" << r%i + 1 << ")\n";
 			}
 			f << "))\n)\n";
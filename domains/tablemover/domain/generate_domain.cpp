@@ -0,0 +1,291 @@
+
+#include <cstring>
+
+#include "../../generator/Generator.h"
+
+using namespace generator;
+
+// The action schemas below are copied verbatim from generate_domain.py so that
+// both generators produce the same domains. Every "%d" is replaced by the index
+// of the table.
+static const char * PREDICATES = R"(
+    (:predicates
+    	(on-table ?b - block ?t - table)
+    	(on-floor ?b - block)
+    	(down ?s - side)
+    	(up ?s - side)
+    	(clear ?s - side)
+    	(at-side ?a - agent ?s - side)
+    	(lifting ?a - agent ?s - side)
+    	(inroom ?l - locatable ?r - room)
+    	(available ?a - agent)
+    	(handempty ?a - agent)
+    	(holding ?a - agent ?b - block)
+    	(connected ?r1 ?r2 - room)
+    )
+    )";
+static const char * BASIC_ACTIONS = R"(
+    (:action pickup-floor
+        :agent ?a - agent
+        :parameters (?b - block ?r - room)
+        :precondition (and
+                        (on-floor ?b)
+                        (inroom ?a ?r)
+                        (inroom ?b ?r)
+                        (available ?a)
+                        (handempty ?a)
+                        (forall (?a2 - agent) (not (pickup-floor ?a2 ?b ?r)))
+                    )
+    	:effect	(and
+                        (not (on-floor ?b))
+                        (not (inroom ?b ?r))
+                        (not (handempty ?a))
+                        (holding ?a ?b)
+                )
+    )
+    (:action putdown-floor
+        :agent ?a - agent
+    	:parameters (?b - block ?r - room)
+    	:precondition (and
+                            (available ?a)
+                            (inroom ?a ?r)
+                            (holding ?a ?b)
+                        )
+    	:effect	(and
+                    (on-floor ?b)
+                    (inroom ?b ?r)
+                    (handempty ?a)
+                    (not (holding ?a ?b))
+                )
+    )
+    )";
+static const char * MOVE_AGENT_ACTION = R"(
+    (:action move-agent
+        :agent ?a - agent
+        :parameters (?r1 ?r2 - room)
+        :precondition (and
+                        (available ?a)    
+                        (inroom ?a ?r1)
+                        (connected ?r1 ?r2)
+                    )
+        :effect (and
+                    (not (inroom ?a ?r1))
+                    (inroom ?a ?r2)
+                )
+    )
+    )";
+static const char * TABLE_PICKUP_ACTIONS = R"(
+    (:action pickup-table-%d
+        :agent ?a - agent
+        :parameters (?b - block ?r - room)
+        :precondition (and
+                        (on-table ?b Table%d)
+                        (inroom ?a ?r)
+                        (inroom Table%d ?r)
+                        (available ?a)
+                        (handempty ?a)
+                        (forall (?a2 - agent) (not (pickup-table-%d ?a2 ?b ?r)))
+                    )
+        :effect (and
+                    (not (on-table ?b Table%d))
+                    (not (handempty ?a))
+                    (holding ?a ?b)
+                )
+    )
+    (:action putdown-table-%d
+        :agent ?a - agent
+        :parameters (?b - block ?r - room)
+        :precondition (and
+                        (inroom ?a ?r)
+                        (inroom Table%d ?r)
+                        (available ?a)
+                        (holding ?a ?b)
+                        ; check table not lifted
+                        (forall (?s - side%d)
+                            (down ?s)
+                        )
+                        ; check table not intended to be lifted!
+                        (forall (?a2 - agent ?s - side%d) (not (lift-side-%d ?a2 ?s)))
+                    )
+    	:effect	(and
+                        (on-table ?b Table%d)
+                        (handempty ?a)
+                        (not (holding ?a ?b))
+                    )
+    )
+    )";
+static const char * TABLE_SIDE_ACTIONS = R"(
+    (:action to-table-%d
+        :agent ?a - agent
+    	:parameters (?r - room ?s - side%d)
+    	:precondition (and
+                        (clear ?s)
+                        (inroom ?a ?r)
+                        (inroom Table%d ?r)
+                        (available ?a)
+                        (forall (?a2 - agent) (not (to-table-%d ?a2 ?r ?s)))
+                    )
+    	:effect	(and
+                    (not (clear ?s))
+                    (at-side ?a ?s)
+                    (not (available ?a))
+                )
+    )
+    (:action leave-table-%d
+        :agent ?a - agent
+        :parameters (?s - side%d)
+        :precondition (and
+                        (at-side ?a ?s)
+                        (not (lifting ?a ?s))
+                    )
+        :effect	(and
+                        (clear ?s)
+                        (not (at-side ?a ?s))
+                        (available ?a)
+                )
+    )
+    )";
+static const char * MOVE_TABLE_ACTION = R"(
+    (:action move-table-%d
+        :agent ?a - agent
+        :parameters (?r1 ?r2 - room ?s - side%d)
+        :precondition (and
+                        (lifting ?a ?s)
+                        (inroom ?a ?r1)
+                        (connected ?r1 ?r2)
+                        (exists (?a2 - agent ?s2 - side%d)
+                            (and
+                                (not (= ?s ?s2))
+                                (move-table-%d ?a2 ?r1 ?r2 ?s2)
+                            )
+                        )
+                    )
+        :effect (and
+                    (not (inroom ?a ?r1))
+                    (not (inroom Table%d ?r1))
+                    (inroom ?a ?r2)
+                    (inroom Table%d ?r2)
+                )
+    )
+    )";
+static const char * LIFT_SIDE_ACTION = R"(
+    (:action lift-side-%d
+        :agent ?a - agent
+        :parameters (?s - side%d)
+        :precondition (and
+                        (down ?s)
+                        (at-side ?a ?s)
+                        (handempty ?a)
+                        (forall (?a2 - agent ?s2 - side%d)
+                            (not (lower-side-%d ?a2 ?s2))
+                        )
+                    )
+        :effect (and
+                    (not (down ?s))
+                    (up ?s)
+                    (lifting ?a ?s)
+                    (not (handempty ?a))
+                    (forall (?b - block ?r - room ?s2 - side%d)
+                            (when (and
+                                    (inroom Table%d ?r)
+                                    (on-table ?b Table%d)
+                                    (down ?s2)
+                                    (forall (?a2 - agent)
+                                            (not (lift-side-%d ?a2 ?s2))
+                                    )
+                                )
+                                (and
+                                    (on-floor ?b)
+                                    (inroom ?b ?r)
+                                    (not (on-table ?b Table%d))
+                                )
+                            )
+                    )
+    	)
+    )
+    )";
+static const char * LOWER_SIDE_ACTION = R"(
+    (:action lower-side-%d
+        :agent ?a - agent
+        :parameters (?s - side%d)
+        :precondition (and
+                        (lifting ?a ?s)
+                        (forall (?a2 - agent ?s2 - side%d)
+                            (not (lift-side-%d ?a2 ?s2))
+                        )
+                    )
+        :effect (and
+                    (down ?s)
+                    (not (up ?s))
+                    (not (lifting ?a ?s))
+                    (handempty ?a)
+                    (forall (?b - block ?r - room ?s2 - side%d)
+                            (when (and
+                                    (inroom Table%d ?r)
+                                    (on-table ?b Table%d)
+                                    (up ?s2)
+                                    (forall (?a2 - agent)
+                                        (not (lower-side-%d ?a2 ?s2))
+                                    )
+                                )
+                                (and
+                                    (on-floor ?b)
+                                    (inroom ?b ?r)
+                                    (not (on-table ?b Table%d))
+                                )
+                            )
+                    )
+            )
+    )
+    )";
+
+static void printTemplate( std::ostream & f, const char * t, int i )
+{
+	for ( const char * p = std::strstr( t, "%d" ); p; p = std::strstr( t, "%d" ) ) {
+		f.write( t, p - t );
+		f << i;
+		t = p + 2;
+	}
+	f << t;
+}
+
+int main( int argc, char * argv[] ) {
+	if ( argc < 3 ) {
+		std::cout << "Usage: generate_tablemover_domain <num-tables> <add-move-agent-action>\n";
+		std::exit( 0 );
+	}
+
+	int numTables = intArg( argv[1] );
+	bool addMoveAgentAction = boolArg( argv[2] );
+
+	std::ostringstream os;
+	os << "table_domain" << numTables << ".pddl";
+	std::ofstream f( os.str().c_str() );
+
+	f << "(define (domain tablemover)\n";
+	f << "(:requirements :typing :conditional-effects :multi-agent)\n";
+	f << "(:types agent block table - locatable\n";
+	for ( int i = 0; i < numTables; ++i )
+		f << "\tside" << i << " - side\n";
+	f << "\tlocatable room side\n";
+	f << ")\n";
+
+	f << "(:constants ";
+	for ( int i = 0; i < numTables; ++i )
+		f << "Table" << i << " ";
+	f << "- table)";
+
+	f << PREDICATES << BASIC_ACTIONS;
+	if ( addMoveAgentAction ) f << MOVE_AGENT_ACTION;
+
+	for ( int i = 0; i < numTables; ++i ) {
+		printTemplate( f, TABLE_PICKUP_ACTIONS, i );
+		printTemplate( f, TABLE_SIDE_ACTIONS, i );
+		printTemplate( f, MOVE_TABLE_ACTION, i );
+		printTemplate( f, LIFT_SIDE_ACTION, i );
+		printTemplate( f, LOWER_SIDE_ACTION, i );
+	}
+
+	f << ")";
+	f.close();
+}
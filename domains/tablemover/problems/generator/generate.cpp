@@ -0,0 +1,70 @@
+
+#include "../../../generator/Generator.h"
+
+using namespace generator;
+
+int main( int argc, char * argv[] ) {
+	if ( argc < 7 ) {
+		std::cout << "Usage: generate_tablemover <num-nodes> <num-edges> <num-blocks> <num-agents> <num-tables> <instance-number> [seed]\n";
+		std::exit( 0 );
+	}
+
+	int numNodes = intArg( argv[1] ), numEdges = intArg( argv[2] ), numBlocks = intArg( argv[3] );
+	int numAgents = intArg( argv[4] ), numTables = intArg( argv[5] ), instanceNumber = intArg( argv[6] );
+	if ( numNodes < 1 ) fail( "At least one room is needed" );
+
+	Random rnd( seedArg( argc, argv, 7 ) );
+
+	EdgeVec edges = randomConnectedGraph( numNodes, numEdges, rnd );
+
+	std::vector< int > blocksLoc( numBlocks ), agentsLoc( numAgents, 0 ), tablesLoc( numTables );
+	for ( int i = 0; i < numBlocks; ++i ) blocksLoc[i] = rnd.uniform( numNodes );
+	for ( int i = 0; i < numTables; ++i ) {
+		tablesLoc[i] = rnd.uniform( numNodes );
+		for ( int j = 2 * i; j < 2 * i + 2 && j < numAgents; ++j )
+			agentsLoc[j] = tablesLoc[i];
+	}
+	int finalLoc = rnd.uniform( numNodes );
+
+	std::ios::sync_with_stdio( false );
+	std::ostream & f = std::cout;
+
+	f << "(define (problem table" << numNodes << "_" << numBlocks << "_" << numTables << "_" << instanceNumber << ") (:domain tablemover)\n";
+	f << "(:objects\n";
+	for ( int i = 0; i < numAgents; ++i ) f << "\ta" << i << " - agent\n";
+	for ( int i = 0; i < numBlocks; ++i ) f << "\tb" << i << " - block\n";
+	for ( int i = 0; i < numNodes; ++i ) f << "\tr" << i << " - room\n";
+	for ( int i = 0; i < numTables; ++i ) f << "\tleft" << i << " right" << i << " - side" << i << "\n";
+	f << ")\n";
+
+	f << "(:init\n";
+	for ( int i = 0; i < numBlocks; ++i ) f << "\t(on-floor b" << i << ")\n";
+	for ( int i = 0; i < numBlocks; ++i ) f << "\t(inroom b" << i << " r" << blocksLoc[i] << ")\n";
+	for ( int i = 0; i < numAgents; ++i ) f << "\t(inroom a" << i << " r" << agentsLoc[i] << ")\n";
+	for ( int i = 0; i < numAgents; ++i ) f << "\t(available a" << i << ")\n";
+	for ( int i = 0; i < numAgents; ++i ) f << "\t(handempty a" << i << ")\n";
+	for ( const Edge & e : edges ) {
+		f << "\t(connected r" << e.first << " r" << e.second << ")\n";
+		f << "\t(connected r" << e.second << " r" << e.first << ")\n";
+	}
+	for ( int i = 0; i < numTables; ++i ) {
+		f << "\t(down left" << i << ")\n";
+		f << "\t(down right" << i << ")\n";
+	}
+	for ( int i = 0; i < numTables; ++i ) {
+		f << "\t(clear left" << i << ")\n";
+		f << "\t(clear right" << i << ")\n";
+	}
+	for ( int i = 0; i < numTables; ++i ) f << "\t(inroom Table" << i << " r" << tablesLoc[i] << ")\n";
+	f << ")\n";
+
+	f << "(:goal (and\n";
+	for ( int i = 0; i < numTables; ++i ) {
+		f << "\t(down left" << i << ")\n";
+		f << "\t(down right" << i << ")\n";
+	}
+	for ( int i = 0; i < numBlocks; ++i ) f << "\t(on-floor b" << i << ")\n";
+	for ( int i = 0; i < numBlocks; ++i ) f << "\t(inroom b" << i << " r" << finalLoc << ")\n";
+	f << "))\n";
+	f << ")\n";
+}
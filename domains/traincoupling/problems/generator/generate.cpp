@@ -0,0 +1,96 @@
+
+#include <map>
+
+#include "../../../generator/Generator.h"
+
+using namespace generator;
+
+typedef std::map< std::string, std::pair< int, int > > LocMap;
+
+static void printObjects( std::ostream & f, const char * type, const char * prefix, long n ) {
+	if ( n > 0 ) {
+		f << "\t";
+		for ( long o = 1; o <= n; ++o ) f << prefix << o << " ";
+		f << "- " << type << "\n";
+	}
+}
+
+static void printInit( std::ostream & f, const char * prefix, int n, int size, Random & rnd, LocMap & locs ) {
+	for ( int o = 1; o <= n; ++o ) {
+		std::ostringstream os;
+		os << prefix << o;
+		int r = rnd.range( 1, size ), c = rnd.range( 1, size );
+		f << "\t(at-yard " << os.str() << " y" << r << "x" << c << ")\n";
+		locs[os.str()] = std::make_pair( r, c );
+	}
+}
+
+int main( int argc, char * argv[] ) {
+	if ( argc < 5 ) {
+		std::cout << "Usage: generate_traincoupling <size> <locomotives> <wagons> <tracks> [seed]\n";
+		std::exit( 0 );
+	}
+
+	int size = intArg( argv[1] ), locomotives = intArg( argv[2] ), wagons = intArg( argv[3] ), tracks = intArg( argv[4] );
+	if ( size < 2 ) fail( "The grid needs a lateral size of at least 2" );
+
+	Random rnd( seedArg( argc, argv, 5 ) );
+
+	// number of directed tracks between adjacent yards
+	long totalTracks = long( size - 2 ) * ( size - 2 ) * 4 * tracks + 4 * ( 2 * tracks ) + 4L * ( size - 2 ) * ( 3 * tracks );
+
+	std::ostringstream name;
+	name << "p" << size << "_" << locomotives << "_" << wagons << "_" << tracks;
+
+	std::ofstream f( ( name.str() + ".pddl" ).c_str() );
+	f << "(define (problem " << name.str() << ") (:domain traincoupling)\n";
+
+	f << "(:objects\n";
+	printObjects( f, "locomotive", "l", locomotives );
+	printObjects( f, "wagon", "w", wagons );
+	printObjects( f, "track", "t", totalTracks );
+	f << "\t";
+	for ( int r = 1; r <= size; ++r )
+		for ( int c = 1; c <= size; ++c )
+			f << "y" << r << "x" << c << " ";
+	f << "- yard\n";
+	f << ")\n";
+
+	LocMap locs;
+	f << "(:init\n";
+	printInit( f, "l", locomotives, size, rnd, locs );
+	printInit( f, "w", wagons, size, rnd, locs );
+	for ( int w = 1; w <= wagons; ++w ) f << "\t(unattached w" << w << ")\n";
+
+	long trackId = 1;
+	for ( int r = 1; r <= size; ++r )
+		for ( int c = 1; c <= size; ++c ) {
+			if ( r > 1 )
+				for ( int i = 0; i < tracks; ++i )
+					f << "\t(has-track t" << trackId++ << " y" << r << "x" << c << " y" << r - 1 << "x" << c << ")\n";
+			if ( r < size )
+				for ( int i = 0; i < tracks; ++i )
+					f << "\t(has-track t" << trackId++ << " y" << r << "x" << c << " y" << r + 1 << "x" << c << ")\n";
+			if ( c > 1 )
+				for ( int i = 0; i < tracks; ++i )
+					f << "\t(has-track t" << trackId++ << " y" << r << "x" << c << " y" << r << "x" << c - 1 << ")\n";
+			if ( c < size )
+				for ( int i = 0; i < tracks; ++i )
+					f << "\t(has-track t" << trackId++ << " y" << r << "x" << c << " y" << r << "x" << c + 1 << ")\n";
+		}
+	f << ")\n";
+
+	f << "(:goal (and\n";
+	for ( int o = 1; o <= wagons; ++o ) {
+		std::ostringstream os;
+		os << "w" << o;
+		std::pair< int, int > p;
+		do p = std::make_pair( rnd.range( 1, size ), rnd.range( 1, size ) );
+		while ( p == locs[os.str()] );
+		f << "\t(at-yard " << os.str() << " y" << p.first << "x" << p.second << ")\n";
+	}
+	for ( int w = 1; w <= wagons; ++w ) f << "\t(unattached w" << w << ")\n";
+	f << "))\n";
+	f << ")\n";
+	f.close();
+}
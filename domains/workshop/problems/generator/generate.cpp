@@ -0,0 +1,116 @@
+
+#include "../../../generator/Generator.h"
+
+using namespace generator;
+
+static std::string room( unsigned bigRoom, unsigned smallRoom ) {
+	std::ostringstream os;
+	os << "r" << bigRoom << "n" << smallRoom;
+	return os.str();
+}
+
+int main( int argc, char * argv[] ) {
+	if ( argc < 6 ) {
+		std::cout << "Usage: generate_workshop <num-agents> <num-pallet> <num-big-rooms> <num-small-rooms-per-big-room> <num-instance> [seed]\n";
+		std::exit( 0 );
+	}
+
+	int numAgents = intArg( argv[1] ), numPallet = intArg( argv[2] ), numBigRooms = intArg( argv[3] );
+	int numSmallRooms = intArg( argv[4] ), numInstance = intArg( argv[5] );
+	if ( numBigRooms < 1 || numSmallRooms < 1 ) fail( "At least one building with one room is needed" );
+
+	Random rnd( seedArg( argc, argv, 6 ) );
+
+	typedef std::pair< std::string, std::string > RoomPair;
+	std::vector< RoomPair > edgeSet, lockedEdges;
+
+	for ( int i = 0; i < numBigRooms; ++i )
+		for ( const Edge & e : randomConnectedGraph( numSmallRooms, numSmallRooms - 1, rnd ) )
+			edgeSet.emplace_back( room( i, e.first ), room( i, e.second ) );
+
+	EdgeVec bigRoomConnections = randomConnectedGraph( numBigRooms, numBigRooms - 1, rnd );
+	for ( const Edge & e : bigRoomConnections ) {
+		unsigned n0 = rnd.uniform( numSmallRooms ), n1 = rnd.uniform( numSmallRooms );
+		lockedEdges.emplace_back( room( e.first, n0 ), room( e.second, n1 ) );
+	}
+
+	std::vector< std::string > palletLocations, agentLocations, forkliftLocations;
+	for ( int i = 0; i < numPallet; ++i ) {
+		unsigned bigRoom = rnd.uniform( numBigRooms );
+		palletLocations.push_back( room( bigRoom, rnd.uniform( numSmallRooms ) ) );
+	}
+
+	for ( int i = 0; i < numAgents; i += 2 ) {
+		unsigned bigRoom = rnd.uniform( numBigRooms );
+		unsigned smallRoomA1 = rnd.uniform( numSmallRooms );
+		unsigned smallRoomA2 = rnd.uniform( numSmallRooms );
+		unsigned smallRoomForklift = rnd.uniform( numSmallRooms );
+		agentLocations.push_back( room( bigRoom, smallRoomA1 ) );
+		agentLocations.push_back( room( bigRoom, smallRoomA2 ) );
+		forkliftLocations.push_back( room( bigRoom, smallRoomForklift ) );
+	}
+
+	std::vector< std::string > switchLocations, keyLocations;
+	std::vector< unsigned > switchConnections, keyFits;
+	unsigned doorId = edgeSet.size();
+	for ( const Edge & e : bigRoomConnections ) {
+		unsigned smallRoomKey0 = rnd.uniform( numSmallRooms );
+		unsigned smallRoomSwitch0 = rnd.uniform( numSmallRooms );
+		unsigned smallRoomKey1 = rnd.uniform( numSmallRooms );
+		unsigned smallRoomSwitch1 = rnd.uniform( numSmallRooms );
+
+		switchLocations.push_back( room( e.first, smallRoomSwitch0 ) );
+		switchLocations.push_back( room( e.second, smallRoomSwitch1 ) );
+		keyLocations.push_back( room( e.first, smallRoomKey0 ) );
+		keyLocations.push_back( room( e.second, smallRoomKey1 ) );
+
+		switchConnections.push_back( doorId );
+		switchConnections.push_back( doorId );
+		keyFits.push_back( doorId );
+		keyFits.push_back( doorId );
+		++doorId;
+	}
+
+	std::ios::sync_with_stdio( false );
+	std::ostream & f = std::cout;
+
+	f << "(define (problem workshop" << numAgents << "_" << numPallet << "_" << numBigRooms << "_" << numSmallRooms << "_" << numInstance << ") (:domain workshop)\n";
+
+	f << "(:objects\n";
+	for ( int i = 0; i < numBigRooms; ++i )
+		for ( int j = 0; j < numSmallRooms; ++j )
+			f << "\tr" << i << "n" << j << " - room\n";
+	for ( unsigned i = 0; i < edgeSet.size() + lockedEdges.size(); ++i ) f << "\td" << i << " - door\n";
+	for ( int i = 0; i < numPallet; ++i ) f << "\tp" << i << " - pallet\n";
+	for ( int i = 0; i < numAgents; ++i ) f << "\ta" << i << " - agent\n";
+	for ( int i = 0; i < numAgents / 2; ++i ) f << "\tf" << i << " - forklift\n";
+	for ( unsigned i = 0; i < 2 * lockedEdges.size(); ++i ) f << "\tk" << i << " - key\n";
+	for ( unsigned i = 0; i < 2 * lockedEdges.size(); ++i ) f << "\ts" << i << " - switch\n";
+	f << ")\n";
+
+	f << "(:init\n";
+	for ( unsigned i = 0; i < edgeSet.size(); ++i ) {
+		f << "\t(adjacent " << edgeSet[i].first << " " << edgeSet[i].second << " d" << i << ")\n";
+		f << "\t(adjacent " << edgeSet[i].second << " " << edgeSet[i].first << " d" << i << ")\n";
+	}
+	for ( unsigned i = 0; i < lockedEdges.size(); ++i ) {
+		f << "\t(adjacent " << lockedEdges[i].first << " " << lockedEdges[i].second << " d" << i + edgeSet.size() << ")\n";
+		f << "\t(adjacent " << lockedEdges[i].second << " " << lockedEdges[i].first << " d" << i + edgeSet.size() << ")\n";
+	}
+	for ( unsigned i = 0; i < edgeSet.size(); ++i ) f << "\t(unlocked d" << i << ")\n";
+	for ( unsigned i = 0; i < lockedEdges.size(); ++i ) f << "\t(locked d" << i + edgeSet.size() << ")\n";
+	for ( int i = 0; i < numPallet; ++i ) f << "\t(inroom p" << i << " " << palletLocations[i] << ")\n";
+	for ( int i = 0; i < numAgents; ++i ) f << "\t(inroom a" << i << " " << agentLocations[i] << ")\n";
+	for ( int i = 0; i < numAgents / 2; ++i ) f << "\t(inroom f" << i << " " << forkliftLocations[i] << ")\n";
+	for ( unsigned i = 0; i < keyLocations.size(); ++i ) f << "\t(inroom k" << i << " " << keyLocations[i] << ")\n";
+	for ( unsigned i = 0; i < switchLocations.size(); ++i ) f << "\t(inroom s" << i << " " << switchLocations[i] << ")\n";
+	for ( int i = 0; i < numAgents / 2; ++i ) f << "\t(empty f" << i << ")\n";
+	for ( unsigned i = 0; i < switchConnections.size(); ++i ) f << "\t(connected s" << i << " d" << switchConnections[i] << ")\n";
+	for ( unsigned i = 0; i < keyFits.size(); ++i ) f << "\t(fits k" << i << " d" << keyFits[i] << ")\n";
+	f << ")\n";
+
+	f << "(:goal (and\n";
+	for ( int i = 0; i < numPallet; ++i ) f << "\t(examined p" << i << ")\n";
+	f << "))\n";
+	f << ")\n";
+}
@@ -0,0 +1,324 @@
+#include <parser/Instance.h>
+#include <multiagent/ConcurrencyCompiler.h>
+#include <multiagent/DomainCache.h>
+#include <multiagent/NetworkCompiler.h>
+#include <multiagent/Parallel.h>
+#include <multiagent/Simplifier.h>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <cstring>
+
+using namespace parser::pddl;
+
+namespace fs = std::filesystem;
+
+void showHelp() {
+    std::cout << "Usage: ./batch_compile [options] <network|concurrency> <domain.pddl> <problem>...\n";
+    std::cout << "Compiles every problem against a single domain into an output directory.\n";
+    std::cout << "A problem is a file, a directory (all its .pddl files) or a quoted glob such as 'problems/p*.pddl'.\n";
+    std::cout << "Compilers:\n";
+    std::cout << "    network                        -- Concurrency network compilation (as serialize_cn).\n";
+    std::cout << "    concurrency                    -- Concurrency constraint compilation (as serialize).\n";
+    std::cout << "Options:\n";
+    std::cout << "    -h                             -- Print this message.\n";
+    std::cout << "    -d, --output-dir <dir>         -- Output directory (default: current directory).\n";
+    std::cout << "    -t, --threads <n>              -- Number of worker threads (default: hardware threads).\n";
+    std::cout << "    -j, --max-joint-action-size    -- Maximum number of atomic actions per joint action (concurrency).\n";
+    std::cout << "    -o, --use-agent-order          -- Agents do actions in an specific order (concurrency).\n";
+    std::cout << "    --no-simplify                  -- Print the classical domain without simplifying its actions.\n";
+    std::cout << "    --keep-static                  -- Do not use static predicates to specialise the actions.\n";
+    std::cout << "    -b, --bounded-counters         -- Count actions with bounded propositional counters (network).\n";
+    std::cout << "    -y, --symmetry                 -- Interchangeable agents start acting in a fixed order (network).\n";
+    std::cout << "    -c, --cache <dir>              -- Reuse the classical domain compiled by previous runs.\n";
+    std::cout << "    --cache-size <MB>              -- Maximum size of the cache (default: 256).\n";
+    std::cout << "    --clear-cache                  -- Remove all the entries of the cache first.\n";
+    exit( 1 );
+}
+
+typedef struct ProgramParams {
+    std::string compiler, domain, outputDir;
+    std::vector< std::string > problems;
+    unsigned threads;
+    bool agentOrder; // use fixed agent order
+    int maxJointActionSize; // maximum number of atomic actions per joint action
+    bool simplify; // simplify the actions of the classical domain
+    bool inlineStatic; // use static predicates to specialise the actions
+    bool boundedCounters; // bounded counters instead of AGENT-COUNT objects (network)
+    bool symmetry; // break the symmetries between interchangeable agents (network)
+    std::string cacheDir; // cache of compiled domains (disabled if empty)
+    unsigned cacheSize; // size limit of the cache in MB
+    bool clearCache;
+
+    ProgramParams( int argc, char * argv[] ) : outputDir( "." ), threads( parser::multiagent::defaultThreads() ), agentOrder( false ), maxJointActionSize( -1 ), simplify( true ), inlineStatic( true ), boundedCounters( false ), symmetry( false ), cacheSize( 256 ), clearCache( false ) {
+        parseInputParameters( argc, argv );
+    }
+
+    void parseInputParameters( int argc, char * argv[] ) {
+        int i = 1;
+        for ( ; i < argc && argv[i][0] == '-'; ++i ) {
+            if ( ( !strcmp( argv[i], "-d" ) || !strcmp( argv[i], "--output-dir" ) ) && i + 1 < argc ) {
+                outputDir = argv[++i];
+            }
+            else if ( ( !strcmp( argv[i], "-t" ) || !strcmp( argv[i], "--threads" ) ) && i + 1 < argc ) {
+                threads = std::max( 1, atoi( argv[++i] ) );
+            }
+            else if ( ( !strcmp( argv[i], "-j" ) || !strcmp( argv[i], "--max-joint-action-size" ) ) && i + 1 < argc ) {
+                maxJointActionSize = atoi( argv[++i] );
+            }
+            else if ( !strcmp( argv[i], "-o" ) || !strcmp( argv[i], "--use-agent-order" ) ) {
+                agentOrder = true;
+            }
+            else if ( !strcmp( argv[i], "--no-simplify" ) ) {
+                simplify = false;
+            }
+            else if ( !strcmp( argv[i], "--keep-static" ) ) {
+                inlineStatic = false;
+            }
+            else if ( !strcmp( argv[i], "-b" ) || !strcmp( argv[i], "--bounded-counters" ) ) {
+                boundedCounters = true;
+            }
+            else if ( !strcmp( argv[i], "-y" ) || !strcmp( argv[i], "--symmetry" ) ) {
+                symmetry = true;
+            }
+            else if ( ( !strcmp( argv[i], "-c" ) || !strcmp( argv[i], "--cache" ) ) && i + 1 < argc ) {
+                cacheDir = argv[++i];
+            }
+            else if ( !strcmp( argv[i], "--cache-size" ) && i + 1 < argc ) {
+                cacheSize = atoi( argv[++i] );
+            }
+            else if ( !strcmp( argv[i], "--clear-cache" ) ) {
+                clearCache = true;
+            }
+            else {
+                showHelp();
+            }
+        }
+
+        if ( argc < i + 3 ) {
+            showHelp();
+        }
+
+        compiler = argv[i];
+        domain = argv[i + 1];
+        if ( compiler != "network" && compiler != "concurrency" ) {
+            showHelp();
+        }
+
+        for ( int j = i + 2; j < argc; ++j ) {
+            expandProblems( argv[j] );
+        }
+    }
+
+    // matches a file name against a pattern with '*' and '?' wildcards
+    static bool wildcardMatch( const char * p, const char * s ) {
+        if ( *p == 0 ) return *s == 0;
+        if ( *p == '*' ) return wildcardMatch( p + 1, s ) || ( *s && wildcardMatch( p, s + 1 ) );
+        return *s && ( *p == '?' || *p == *s ) && wildcardMatch( p + 1, s + 1 );
+    }
+
+    // directories and globs are expanded here so that huge problem sets do
+    // not hit the argument length limit of the shell
+    void expandProblems( const std::string & arg ) {
+        fs::path p( arg );
+        std::string pattern;
+        if ( fs::is_directory( p ) ) {
+            pattern = "*.pddl";
+        }
+        else if ( arg.find_first_of( "*?" ) != std::string::npos ) {
+            pattern = p.filename().string();
+            p = p.parent_path().empty() ? fs::path( "." ) : p.parent_path();
+        }
+        else {
+            problems.push_back( arg );
+            return;
+        }
+
+        std::vector< std::string > matches;
+        for ( const auto & entry : fs::directory_iterator( p ) ) {
+            if ( entry.is_regular_file() && wildcardMatch( pattern.c_str(), entry.path().filename().string().c_str() ) ) {
+                matches.push_back( entry.path().string() );
+            }
+        }
+        std::sort( matches.begin(), matches.end() );
+        problems.insert( problems.end(), matches.begin(), matches.end() );
+    }
+
+} ProgramParams;
+
+// removes the objects that parsing an instance added to the types of the
+// domain, so that the domain can be reused for the next instance
+void clearObjects( Domain & d ) {
+    for ( const auto & type : d.types ) {
+        type->objects.clear();
+    }
+}
+
+// One compiler per worker thread: parsing an instance adds its objects to
+// the types of the domain, so the multiagent domain cannot be shared between
+// threads. Each worker parses the domain once and reuses it for every
+// problem it is handed.
+class BatchCompiler {
+public:
+    virtual ~BatchCompiler() = default;
+
+    // the classical domain; it only depends on the multiagent domain
+    virtual std::shared_ptr< Domain > compileDomain() = 0;
+
+    // compiler name and options identifying the classical domain in the cache
+    virtual std::string cacheOptions() const = 0;
+
+    // parses and compiles the problem, writing the classical problem to os
+    virtual void compileProblem( const std::string & file, std::ostream & os ) = 0;
+};
+
+class NetworkBatchCompiler : public BatchCompiler {
+public:
+    parser::multiagent::MultiagentDomain d;
+    parser::multiagent::NetworkCompiler compiler;
+
+    NetworkBatchCompiler( const std::string & domain, bool inlineStatic, bool boundedCounters, bool symmetry ) : d( domain ), compiler( d, inlineStatic, boundedCounters, symmetry ) {}
+
+    std::shared_ptr< Domain > compileDomain() override {
+        return compiler.compileDomain();
+    }
+
+    std::string cacheOptions() const override {
+        return "k=" + std::to_string( compiler.inlineStatic ) + " b=" + std::to_string( compiler.boundedCounters ) + " y=" + std::to_string( compiler.symmetryBreaking );
+    }
+
+    void compileProblem( const std::string & file, std::ostream & os ) override {
+        {
+            Instance ins( d, file );
+            // the objects of the instance go into the types of the classical
+            // domain, so its signature (but not its actions) is built per problem
+            auto cd = compiler.compileSignature();
+            os << *compiler.compileInstance( *cd, ins );
+        }
+        clearObjects( d );
+    }
+};
+
+class ConcurrencyBatchCompiler : public BatchCompiler {
+public:
+    parser::multiagent::ConcurrencyCompiler compiler;
+    parser::multiagent::ConcurrencyDomain d;
+
+    ConcurrencyBatchCompiler( const std::string & domain, bool agentOrder, int maxJointActionSize, unsigned threads, bool inlineStatic )
+        : compiler( agentOrder, maxJointActionSize, threads, inlineStatic ), d( domain ) {
+        compiler.prepareDomain( d );
+    }
+
+    std::shared_ptr< Domain > compileDomain() override {
+        return compiler.compileDomain( d );
+    }
+
+    std::string cacheOptions() const override {
+        return "j=" + std::to_string( compiler.maxJointActionSize ) + " o=" + std::to_string( compiler.useAgentOrder ) + " k=" + std::to_string( compiler.inlineStatic );
+    }
+
+    void compileProblem( const std::string & file, std::ostream & os ) override {
+        {
+            Instance ins( d, file );
+            auto cd = compiler.compileSignature( d );
+            os << *compiler.compileInstance( *cd, ins );
+        }
+        clearObjects( d );
+    }
+};
+
+std::unique_ptr< BatchCompiler > createCompiler( const ProgramParams & pp ) {
+    if ( pp.compiler == "network" ) {
+        return std::make_unique< NetworkBatchCompiler >( pp.domain, pp.inlineStatic, pp.boundedCounters, pp.symmetry );
+    }
+    return std::make_unique< ConcurrencyBatchCompiler >( pp.domain, pp.agentOrder, pp.maxJointActionSize, pp.threads, pp.inlineStatic );
+}
+
+int main(int argc, char* argv[])
+{
+    ProgramParams pp(argc, argv);
+
+    if (pp.problems.empty()) {
+        std::cerr << "No problems to compile\n";
+        return 1;
+    }
+
+    // output files are named after the problems, so names must be unique
+    std::map<std::string, std::string> names;
+    for (const auto& problem : pp.problems) {
+        std::string stem = fs::path(problem).stem().string();
+        if (stem == "domain" || names.contains(stem)) {
+            std::cerr << "Problem '" << problem << "' would overwrite the output of '" << (stem == "domain" ? "the domain" : names[stem]) << "'\n";
+            return 1;
+        }
+        names[stem] = problem;
+    }
+
+    fs::create_directories(pp.outputDir);
+
+    auto start = std::chrono::steady_clock::now();
+    unsigned threads = std::min<unsigned>(pp.threads, pp.problems.size());
+    std::vector<std::unique_ptr<BatchCompiler>> workers(threads);
+
+    // the domain parsed here is reused by the first worker
+    workers[0] = createCompiler(pp);
+    auto printDomain = [&](std::ostream& os) {
+        auto cd = workers[0]->compileDomain();
+        if (pp.simplify) {
+            parser::multiagent::Simplifier simplifier;
+            simplifier.simplify(*cd);
+            std::cout << "simplified domain, ";
+            simplifier.report(std::cout);
+        }
+        os << *cd;
+    };
+    {
+        std::ofstream f(fs::path(pp.outputDir) / "domain.pddl");
+        std::string text;
+        if (pp.cacheDir.empty()) {
+            printDomain(f);
+        }
+        else {
+            parser::multiagent::DomainCache cache(pp.cacheDir, std::uintmax_t(pp.cacheSize) << 20);
+            if (pp.clearCache)
+                cache.clear();
+            std::string key = parser::multiagent::DomainCache::key(pp.domain, pp.compiler, workers[0]->cacheOptions() + " s=" + std::to_string(pp.simplify));
+            if (!cache.lookup(key, text)) {
+                std::ostringstream os;
+                printDomain(os);
+                text = os.str();
+                cache.store(key, text);
+            }
+            f << text;
+        }
+    }
+
+    std::mutex outputMutex;
+    unsigned failed = 0;
+    parser::multiagent::parallelFor(pp.problems.size(), threads, [&](unsigned job, unsigned worker) {
+        if (!workers[worker])
+            workers[worker] = createCompiler(pp);
+
+        const std::string& problem = pp.problems[job];
+        fs::path out = fs::path(pp.outputDir) / (fs::path(problem).stem().string() + ".pddl");
+        auto t = std::chrono::steady_clock::now();
+        std::ofstream f(out);
+        if (f)
+            workers[worker]->compileProblem(problem, f);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t).count();
+
+        std::lock_guard<std::mutex> lock(outputMutex);
+        if (f) {
+            std::cout << problem << " -> " << out.string() << " (" << ms << " ms)\n";
+        }
+        else {
+            std::cerr << "Failed to write '" << out.string() << "'\n";
+            ++failed;
+        }
+    });
+
+    double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << pp.problems.size() - failed << " of " << pp.problems.size() << " problems compiled with " << threads << " threads in " << s << " s\n";
+    return failed ? 1 : 0;
+}
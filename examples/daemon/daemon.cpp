@@ -0,0 +1,608 @@
+
+#include <parser/Instance.h>
+#include <multiagent/ConcurrencyCompiler.h>
+#include <multiagent/MultiagentDomain.h>
+#include <multiagent/NetworkCompiler.h>
+#include <multiagent/Parallel.h>
+#include <multiagent/Simplifier.h>
+#include "../serialize_cn/compress.h"
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace parser::pddl;
+
+namespace fs = std::filesystem;
+
+typedef std::chrono::steady_clock Clock;
+
+void showHelp() {
+    std::cout << "Usage: ./compile_daemon [options]                     -- Serve requests read from stdin.\n";
+    std::cout << "       ./compile_daemon [options] -s <socket>         -- Serve requests sent to a Unix domain socket.\n";
+    std::cout << "       ./compile_daemon -c <socket> <request>...      -- Send a request to a daemon and print the answer.\n";
+    std::cout << "Requests (one per line):\n";
+    std::cout << "    domain <network|concurrency> <domain.pddl>               -- Compiled domain.\n";
+    std::cout << "    compile <network|concurrency> <domain.pddl> <problem.pddl> -- Compiled problem.\n";
+    std::cout << "    validate <network|concurrency> <domain.pddl> <problem.pddl> -- Parse the problem.\n";
+    std::cout << "    compress <plan>                                            -- Compress a plan of the network compilation.\n";
+    std::cout << "    stats                                                      -- Request latency percentiles.\n";
+    std::cout << "    quit                                                       -- Stop the daemon.\n";
+    std::cout << "Answers are \"OK <bytes>\" or \"ERROR <bytes>\" followed by that many bytes.\n";
+    std::cout << "Options:\n";
+    std::cout << "    -h                             -- Print this message.\n";
+    std::cout << "    -n, --max-requests <n>         -- Requests served at the same time (default: hardware threads).\n";
+    std::cout << "    -j, --max-joint-action-size    -- Maximum number of atomic actions per joint action (concurrency).\n";
+    std::cout << "    -o, --use-agent-order          -- Agents do actions in an specific order (concurrency).\n";
+    std::cout << "    -b, --bounded-counters         -- Count actions with bounded propositional counters (network).\n";
+    std::cout << "    --no-simplify                  -- Do not simplify the actions of the classical domain.\n";
+    exit( 1 );
+}
+
+typedef struct ProgramParams {
+    std::string socket; // serve requests sent to this socket (stdin if empty)
+    std::string client; // send the request to the daemon listening on this socket
+    std::string request;
+    unsigned maxRequests; // requests served at the same time
+    bool agentOrder;
+    int maxJointActionSize;
+    bool boundedCounters;
+    bool simplify;
+
+    ProgramParams( int argc, char * argv[] ) : maxRequests( parser::multiagent::defaultThreads() ), agentOrder( false ), maxJointActionSize( -1 ), boundedCounters( false ), simplify( true ) {
+        int i = 1;
+        for ( ; i < argc && argv[i][0] == '-'; ++i ) {
+            if ( ( !strcmp( argv[i], "-s" ) || !strcmp( argv[i], "--socket" ) ) && i + 1 < argc ) {
+                socket = argv[++i];
+            }
+            else if ( ( !strcmp( argv[i], "-c" ) || !strcmp( argv[i], "--client" ) ) && i + 1 < argc ) {
+                client = argv[++i];
+            }
+            else if ( ( !strcmp( argv[i], "-n" ) || !strcmp( argv[i], "--max-requests" ) ) && i + 1 < argc ) {
+                maxRequests = std::max( 1, atoi( argv[++i] ) );
+            }
+            else if ( ( !strcmp( argv[i], "-j" ) || !strcmp( argv[i], "--max-joint-action-size" ) ) && i + 1 < argc ) {
+                maxJointActionSize = atoi( argv[++i] );
+            }
+            else if ( !strcmp( argv[i], "-o" ) || !strcmp( argv[i], "--use-agent-order" ) ) {
+                agentOrder = true;
+            }
+            else if ( !strcmp( argv[i], "-b" ) || !strcmp( argv[i], "--bounded-counters" ) ) {
+                boundedCounters = true;
+            }
+            else if ( !strcmp( argv[i], "--no-simplify" ) ) {
+                simplify = false;
+            }
+            else {
+                showHelp();
+            }
+        }
+
+        for ( ; i < argc; ++i ) {
+            request += ( request.empty() ? "" : " " ) + std::string( argv[i] );
+        }
+        if ( client.empty() != request.empty() ) {
+            showHelp();
+        }
+    }
+} ProgramParams;
+
+// writes all of s to file descriptor fd
+bool writeAll( int fd, const std::string & s ) {
+    for ( size_t done = 0; done < s.size(); ) {
+        ssize_t n = write( fd, s.data() + done, s.size() - done );
+        if ( n <= 0 ) {
+            return false;
+        }
+        done += n;
+    }
+    return true;
+}
+
+bool answer( int fd, bool ok, const std::string & payload ) {
+    return writeAll( fd, ( ok ? "OK " : "ERROR " ) + std::to_string( payload.size() ) + "\n" + payload );
+}
+
+// A multiagent domain parsed once, with its compiler and its printed
+// classical domain. Parsing a problem adds its objects to the types of the
+// domain, so problems are only parsed in forked processes that leave the
+// loaded domain untouched.
+struct LoadedDomain {
+    std::string compiler, file;
+    fs::file_time_type modified;
+    std::unique_ptr< Domain > d;
+    std::unique_ptr< parser::multiagent::NetworkCompiler > network;
+    parser::multiagent::ConcurrencyCompiler concurrency;
+    std::string text;
+
+    LoadedDomain( const ProgramParams & pp, const std::string & c, const std::string & f )
+        : compiler( c ), file( f ), modified( fs::last_write_time( f ) ), concurrency( pp.agentOrder, pp.maxJointActionSize ) {
+        std::shared_ptr< Domain > cd;
+        if ( compiler == "network" ) {
+            auto md = std::make_unique< parser::multiagent::MultiagentDomain >( file );
+            network = std::make_unique< parser::multiagent::NetworkCompiler >( *md, true, pp.boundedCounters );
+            cd = network->compileDomain();
+            d = std::move( md );
+        }
+        else {
+            auto cdom = std::make_unique< parser::multiagent::ConcurrencyDomain >( file );
+            concurrency.prepareDomain( *cdom );
+            cd = concurrency.compileDomain( *cdom );
+            d = std::move( cdom );
+        }
+        if ( pp.simplify ) {
+            parser::multiagent::Simplifier().simplify( *cd );
+        }
+        std::ostringstream os;
+        os << *cd;
+        text = os.str();
+    }
+
+    // the compiled problem; only called in forked processes
+    std::string compileProblem( const std::string & problem ) {
+        Instance ins( *d, problem );
+        std::shared_ptr< Domain > cd = network ? network->compileSignature() : concurrency.compileSignature( static_cast< parser::multiagent::ConcurrencyDomain & >( *d ) );
+        std::ostringstream os;
+        if ( network ) {
+            os << *network->compileInstance( *cd, ins );
+        }
+        else {
+            os << *concurrency.compileInstance( *cd, ins );
+        }
+        return os.str();
+    }
+};
+
+// The parser prints its errors and exits, so everything that parses a file
+// that has not been parsed before runs in a forked process whose standard
+// output goes to a temporary file. Forked processes also share the loaded
+// domains with the daemon without copying them.
+class Daemon {
+public:
+    const ProgramParams & pp;
+    std::map< std::pair< std::string, std::string >, std::unique_ptr< LoadedDomain > > domains;
+    std::map< std::string, std::vector< double > > latencies; // milliseconds per request kind
+
+    struct Worker {
+        int fd;         // where the answer goes
+        bool closeFd;   // close fd once answered (socket connections)
+        FILE * output;  // standard output of the process
+        Clock::time_point start;
+        std::string kind;
+    };
+    std::map< pid_t, Worker > workers;
+
+    // socket connections whose request line has not arrived yet
+    struct Pending {
+        std::string line;
+        Clock::time_point accepted;
+    };
+    std::map< int, Pending > pending;
+    int listener; // listening socket, or -1 when serving stdin
+
+    // a connection that does not send its request line in this time is dropped
+    static constexpr std::chrono::seconds requestTimeout{ 10 };
+    static constexpr size_t maxRequestSize = 1 << 16;
+
+    Daemon( const ProgramParams & params ) : pp( params ), listener( -1 ) {}
+
+    // Handles one request; returns false when the daemon must stop. Requests
+    // that parse problems or plans are answered by a forked process.
+    bool handle( const std::string & line, int fd, bool closeFd ) {
+        auto start = Clock::now();
+        std::istringstream is( line );
+        std::vector< std::string > words;
+        for ( std::string w; is >> w; ) {
+            words.push_back( w );
+        }
+        std::string kind = words.empty() ? "" : words[0];
+
+        auto reply = [&]( bool ok, const std::string & payload ) {
+            answer( fd, ok, payload );
+            if ( closeFd ) {
+                close( fd );
+            }
+            record( kind, start );
+        };
+
+        if ( kind == "quit" ) {
+            reply( true, "" );
+            return false;
+        }
+        if ( kind == "stats" ) {
+            reply( true, stats() );
+            return true;
+        }
+        if ( kind == "compress" && words.size() == 2 ) {
+            std::string plan = words[1];
+            fork( fd, closeFd, kind, start, [plan]() {
+                std::ifstream f( plan );
+                if ( !f ) {
+                    std::cout << "Failed to open '" << plan << "'\n";
+                    exit( 1 );
+                }
+                std::ostringstream os;
+                compressPlan( f, os );
+                return os.str();
+            } );
+            return true;
+        }
+
+        bool problem = kind == "compile" || kind == "validate";
+        if ( ( kind != "domain" && !problem ) || words.size() != ( problem ? 4u : 3u ) || ( words[1] != "network" && words[1] != "concurrency" ) ) {
+            reply( false, "Bad request '" + line + "'\n" );
+            return true;
+        }
+
+        std::string error;
+        LoadedDomain * ld = lookup( words[1], words[2], error );
+        if ( !ld ) {
+            reply( false, error );
+        }
+        else if ( kind == "domain" ) {
+            reply( true, ld->text );
+        }
+        else {
+            std::string file = words[3];
+            bool compile = kind == "compile";
+            fork( fd, closeFd, kind, start, [ld, file, compile]() {
+                if ( compile ) {
+                    return ld->compileProblem( file );
+                }
+                Instance ins( *ld->d, file );
+                return std::string();
+            } );
+        }
+        return true;
+    }
+
+    // waits for the forked processes; if block, until one of them ends
+    void reap( bool block ) {
+        while ( !workers.empty() ) {
+            int status;
+            pid_t pid = waitpid( -1, &status, block ? 0 : WNOHANG );
+            if ( pid <= 0 ) {
+                return;
+            }
+            auto it = workers.find( pid );
+            if ( it == workers.end() ) {
+                continue;
+            }
+
+            // a process that failed did not answer: its output is the error
+            Worker & w = it->second;
+            if ( !WIFEXITED( status ) || WEXITSTATUS( status ) ) {
+                std::string error;
+                char buffer[4096];
+                rewind( w.output );
+                for ( size_t n; ( n = fread( buffer, 1, sizeof( buffer ), w.output ) ) > 0; ) {
+                    error.append( buffer, n );
+                }
+                answer( w.fd, false, error.empty() ? "Request failed\n" : error );
+            }
+            fclose( w.output );
+            if ( w.closeFd ) {
+                close( w.fd );
+            }
+            record( w.kind, w.start );
+            workers.erase( it );
+            if ( block ) {
+                return;
+            }
+        }
+    }
+
+    void serveStdin() {
+        for ( std::string line; std::getline( std::cin, line ); ) {
+            if ( line.empty() ) {
+                continue;
+            }
+            bool more = handle( line, STDOUT_FILENO, false );
+            // answers on stdout would interleave, so requests are served one by one
+            reap( true );
+            if ( !more ) {
+                break;
+            }
+        }
+        reap( true );
+    }
+
+    int serveSocket() {
+        listener = ::socket( AF_UNIX, SOCK_STREAM, 0 );
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        if ( listener < 0 || pp.socket.size() >= sizeof( addr.sun_path ) ) {
+            std::cerr << "Failed to create socket '" << pp.socket << "'\n";
+            return 1;
+        }
+        strcpy( addr.sun_path, pp.socket.c_str() );
+        unlink( pp.socket.c_str() );
+        if ( bind( listener, ( sockaddr * )&addr, sizeof( addr ) ) < 0 || listen( listener, 64 ) < 0 ) {
+            std::cerr << "Failed to listen on '" << pp.socket << "'\n";
+            return 1;
+        }
+
+        // request lines are read as they arrive on non-blocking sockets, so a
+        // client that connects and does not send its request stalls nothing
+        for ( bool more = true; more; ) {
+            std::vector< pollfd > fds( 1, pollfd{ listener, POLLIN, 0 } );
+            for ( const auto & p : pending ) {
+                fds.push_back( pollfd{ p.first, POLLIN, 0 } );
+            }
+            int ready = poll( fds.data(), fds.size(), 100 );
+            reap( false );
+            expire();
+            if ( ready <= 0 ) {
+                continue;
+            }
+            if ( fds[0].revents & POLLIN ) {
+                int fd = accept( listener, nullptr, nullptr );
+                if ( fd >= 0 ) {
+                    fcntl( fd, F_SETFL, fcntl( fd, F_GETFL ) | O_NONBLOCK );
+                    pending[fd] = Pending{ "", Clock::now() };
+                }
+            }
+            for ( unsigned i = 1; more && i < fds.size(); ++i ) {
+                std::string line;
+                if ( !fds[i].revents || !receive( fds[i].fd, line ) ) {
+                    continue;
+                }
+                // answers are written with blocking writes
+                fcntl( fds[i].fd, F_SETFL, fcntl( fds[i].fd, F_GETFL ) & ~O_NONBLOCK );
+                while ( workers.size() >= pp.maxRequests ) {
+                    reap( true );
+                }
+                more = handle( line, fds[i].fd, true );
+            }
+        }
+        for ( const auto & p : pending ) {
+            close( p.first );
+        }
+        pending.clear();
+        while ( !workers.empty() ) {
+            reap( true );
+        }
+        close( listener );
+        listener = -1;
+        unlink( pp.socket.c_str() );
+        return 0;
+    }
+
+    std::string stats() const {
+        std::ostringstream os;
+        for ( const auto & [kind, v] : latencies ) {
+            auto sorted = v;
+            std::sort( sorted.begin(), sorted.end() );
+            auto percentile = [&sorted]( double p ) {
+                return sorted[size_t( std::max( 1.0, std::ceil( p * sorted.size() ) ) ) - 1];
+            };
+            os << kind << ": " << sorted.size() << " requests, p50 " << percentile( 0.5 ) << " ms, p90 " << percentile( 0.9 )
+               << " ms, p99 " << percentile( 0.99 ) << " ms, max " << sorted.back() << " ms\n";
+        }
+        return os.str();
+    }
+
+private:
+    // Reads what has arrived on pending connection fd. Returns true with the
+    // request in line once its end has arrived; a connection that is closed
+    // or fails before that is dropped.
+    bool receive( int fd, std::string & line ) {
+        Pending & p = pending[fd];
+        char buffer[4096];
+        ssize_t n;
+        while ( ( n = read( fd, buffer, sizeof( buffer ) ) ) > 0 ) {
+            p.line.append( buffer, n );
+            size_t eol = p.line.find( '\n' );
+            if ( eol != std::string::npos || p.line.size() > maxRequestSize ) {
+                line = p.line.substr( 0, eol );
+                pending.erase( fd );
+                return true;
+            }
+        }
+        if ( n < 0 && ( errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR ) ) {
+            return false;
+        }
+        // the client closed its end: the request is what it sent
+        if ( n == 0 && p.line.size() ) {
+            line = p.line;
+            pending.erase( fd );
+            return true;
+        }
+        close( fd );
+        pending.erase( fd );
+        return false;
+    }
+
+    // drops the pending connections that did not send their request in time
+    void expire() {
+        auto now = Clock::now();
+        for ( auto it = pending.begin(); it != pending.end(); ) {
+            if ( now - it->second.accepted < requestTimeout ) {
+                ++it;
+                continue;
+            }
+            answer( it->first, false, "Request timed out\n" );
+            close( it->first );
+            record( "timeout", it->second.accepted );
+            it = pending.erase( it );
+        }
+    }
+
+    // Closes, in a forked process, the listening socket and the connections
+    // of the other requests (all but keep). Otherwise their clients would not
+    // see the end of the connection until this process exits.
+    void closeConnections( int keep ) {
+        if ( listener >= 0 ) {
+            close( listener );
+        }
+        for ( const auto & p : pending ) {
+            close( p.first );
+        }
+        for ( const auto & [pid, w] : workers ) {
+            if ( w.closeFd && w.fd != keep ) {
+                close( w.fd );
+            }
+        }
+    }
+
+    void record( const std::string & kind, Clock::time_point start ) {
+        latencies[kind.empty() ? "invalid" : kind].push_back( std::chrono::duration< double, std::milli >( Clock::now() - start ).count() );
+    }
+
+    // runs f in a forked process that answers with its result
+    void fork( int fd, bool closeFd, const std::string & kind, Clock::time_point start, const std::function< std::string() > & f ) {
+        FILE * output = tmpfile();
+        std::cout.flush();
+        pid_t pid = output ? ::fork() : -1;
+        if ( pid == 0 ) {
+            closeConnections( fd );
+            int out = dup( fd );
+            dup2( fileno( output ), STDOUT_FILENO );
+            std::string result = f();
+            std::cout.flush();
+            _exit( answer( out, true, result ) ? 0 : 1 );
+        }
+        if ( pid < 0 ) {
+            if ( output ) {
+                fclose( output );
+            }
+            answer( fd, false, "Failed to fork\n" );
+            if ( closeFd ) {
+                close( fd );
+            }
+            return;
+        }
+        workers[pid] = Worker{ fd, closeFd, output, start, kind };
+    }
+
+    // Runs f in a forked process and returns whether it succeeded, with its
+    // output in error if it did not
+    bool isolated( const std::function< void() > & f, std::string & error ) {
+        FILE * output = tmpfile();
+        std::cout.flush();
+        pid_t pid = output ? ::fork() : -1;
+        if ( pid == 0 ) {
+            closeConnections( -1 );
+            dup2( fileno( output ), STDOUT_FILENO );
+            f();
+            std::cout.flush();
+            _exit( 0 );
+        }
+        int status = 1;
+        if ( pid > 0 ) {
+            waitpid( pid, &status, 0 );
+        }
+        if ( output ) {
+            char buffer[4096];
+            rewind( output );
+            for ( size_t n; ( n = fread( buffer, 1, sizeof( buffer ), output ) ) > 0; ) {
+                error.append( buffer, n );
+            }
+            fclose( output );
+        }
+        if ( pid < 0 ) {
+            error = "Failed to fork\n";
+        }
+        return pid > 0 && WIFEXITED( status ) && !WEXITSTATUS( status );
+    }
+
+    // the loaded domain, which is loaded again if its file changed since;
+    // a domain that fails to parse keeps the previous version loaded
+    LoadedDomain * lookup( const std::string & compiler, const std::string & file, std::string & error ) {
+        std::error_code ec;
+        auto modified = fs::last_write_time( file, ec );
+        if ( ec ) {
+            error = "Failed to open '" + file + "'\n";
+            return nullptr;
+        }
+
+        auto & ld = domains[std::make_pair( compiler, file )];
+        if ( ld && ld->modified == modified ) {
+            return ld.get();
+        }
+        if ( !isolated( [&]() { LoadedDomain( pp, compiler, file ); }, error ) ) {
+            return nullptr;
+        }
+        std::cerr << ( ld ? "reloading " : "loading " ) << compiler << " domain '" << file << "'\n";
+        ld = std::make_unique< LoadedDomain >( pp, compiler, file );
+        return ld.get();
+    }
+};
+
+// sends the request to the daemon and prints the answer
+int sendRequest( const ProgramParams & pp ) {
+    int fd = socket( AF_UNIX, SOCK_STREAM, 0 );
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if ( fd < 0 || pp.client.size() >= sizeof( addr.sun_path ) ) {
+        std::cerr << "Failed to create socket\n";
+        return 1;
+    }
+    strcpy( addr.sun_path, pp.client.c_str() );
+    if ( connect( fd, ( sockaddr * )&addr, sizeof( addr ) ) < 0 || !writeAll( fd, pp.request + "\n" ) ) {
+        std::cerr << "Failed to connect to '" << pp.client << "'\n";
+        return 1;
+    }
+
+    // "OK <bytes>" or "ERROR <bytes>", and then exactly that many bytes
+    std::string header;
+    char c;
+    while ( read( fd, &c, 1 ) == 1 && c != '\n' ) {
+        header += c;
+    }
+    std::istringstream is( header );
+    std::string status;
+    size_t bytes = 0;
+    if ( !( is >> status >> bytes ) || ( status != "OK" && status != "ERROR" ) ) {
+        close( fd );
+        std::cerr << "Bad answer '" << header << "'\n";
+        return 1;
+    }
+
+    std::string payload( bytes, '\0' );
+    size_t done = 0;
+    for ( ssize_t n; done < bytes && ( n = read( fd, payload.data() + done, bytes - done ) ) > 0; ) {
+        done += n;
+    }
+    close( fd );
+    if ( done < bytes ) {
+        std::cerr << "Incomplete answer: " << done << " of " << bytes << " bytes\n";
+        return 1;
+    }
+
+    bool ok = status == "OK";
+    ( ok ? std::cout : std::cerr ) << payload;
+    return ok ? 0 : 1;
+}
+
+int main( int argc, char * argv[] )
+{
+    ProgramParams pp( argc, argv );
+    if ( pp.client.size() ) {
+        return sendRequest( pp );
+    }
+
+    // clients that disconnect early must not stop the daemon
+    signal( SIGPIPE, SIG_IGN );
+
+    Daemon daemon( pp );
+    int status = 0;
+    if ( pp.socket.empty() ) {
+        daemon.serveStdin();
+    }
+    else {
+        status = daemon.serveSocket();
+    }
+    std::cerr << daemon.stats();
+    return status;
+}
@@ -0,0 +1,99 @@
+
+#include <parser/Instance.h>
+#include <multiagent/ConcurrencyCompiler.h>
+#include <multiagent/Decomposition.h>
+#include <multiagent/MultiagentDomain.h>
+#include <filesystem>
+#include <fstream>
+#include <cstring>
+
+using namespace parser::pddl;
+
+namespace fs = std::filesystem;
+
+void showHelp() {
+    std::cout << "Usage: ./decompose [-d <out-dir>] <network|concurrency> <domain.pddl> <problem.pddl>\n";
+    std::cout << "       ./decompose -m <plan>...\n";
+    std::cout << "Splits a problem into subproblems whose agents never interact, one file per subproblem,\n";
+    std::cout << "or merges the joint plans of the subproblems into a joint plan of the problem.\n";
+    std::cout << "Options:\n";
+    std::cout << "    -h                             -- Print this message.\n";
+    std::cout << "    -d, --output-dir <dir>         -- Output directory of the subproblems (default: current directory).\n";
+    std::cout << "    -m, --merge                    -- Merge plans (written as by compress) and print the result.\n";
+    exit( 1 );
+}
+
+int mergeMain( int argc, char * argv[], int i ) {
+    std::vector< parser::multiagent::JointPlan > plans;
+    for ( ; i < argc; ++i ) {
+        std::ifstream f( argv[i] );
+        if ( !f ) {
+            std::cerr << "Failed to open plan '" << argv[i] << "'\n";
+            return 1;
+        }
+        plans.push_back( parser::multiagent::readPlan( f ) );
+    }
+    parser::multiagent::printPlan( std::cout, parser::multiagent::mergePlans( plans ) );
+    return 0;
+}
+
+int main( int argc, char * argv[] )
+{
+    std::string outputDir = ".";
+    int i = 1;
+    for ( ; i < argc && argv[i][0] == '-'; ++i ) {
+        if ( ( !strcmp( argv[i], "-d" ) || !strcmp( argv[i], "--output-dir" ) ) && i + 1 < argc ) {
+            outputDir = argv[++i];
+        }
+        else if ( !strcmp( argv[i], "-m" ) || !strcmp( argv[i], "--merge" ) ) {
+            return mergeMain( argc, argv, i + 1 );
+        }
+        else {
+            showHelp();
+        }
+    }
+
+    if ( argc != i + 3 ) {
+        showHelp();
+    }
+
+    std::string compiler = argv[i], domain = argv[i + 1], problem = argv[i + 2];
+    std::unique_ptr< Domain > d;
+    if ( compiler == "network" ) {
+        d = std::make_unique< parser::multiagent::MultiagentDomain >( domain );
+    }
+    else if ( compiler == "concurrency" ) {
+        // adds the AGENT type if the domain does not declare it
+        auto cd = std::make_unique< parser::multiagent::ConcurrencyDomain >( domain );
+        parser::multiagent::ConcurrencyCompiler().prepareDomain( *cd );
+        d = std::move( cd );
+    }
+    else {
+        showHelp();
+    }
+
+    Instance ins( *d, problem );
+    parser::multiagent::Decomposition decomposition( *d, ins );
+    if ( decomposition.reason.size() ) {
+        std::cout << "Not decomposed: " << decomposition.reason << "\n";
+    }
+
+    fs::create_directories( outputDir );
+    std::string stem = fs::path( problem ).stem().string();
+    for ( unsigned k = 0; k < decomposition.subproblems.size(); ++k ) {
+        fs::path out = fs::path( outputDir ) / ( stem + "-" + std::to_string( k + 1 ) + ".pddl" );
+        std::ofstream f( out );
+        if ( !f ) {
+            std::cerr << "Failed to write '" << out.string() << "'\n";
+            return 1;
+        }
+        decomposition.PDDLPrint( f, k );
+
+        std::cout << out.string() << ":";
+        for ( const auto & a : decomposition.subproblems[k].agents ) {
+            std::cout << " " << a;
+        }
+        std::cout << "\n";
+    }
+    return 0;
+}
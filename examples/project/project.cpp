@@ -0,0 +1,94 @@
+
+#include <parser/Instance.h>
+#include <multiagent/ConcurrencyCompiler.h>
+#include <multiagent/MultiagentDomain.h>
+#include <multiagent/Parallel.h>
+#include <multiagent/Projection.h>
+#include <filesystem>
+#include <fstream>
+#include <cstring>
+
+using namespace parser::pddl;
+
+namespace fs = std::filesystem;
+
+void showHelp() {
+    std::cout << "Usage: ./project [-d <out-dir>] [-t <n>] <network|concurrency> <domain.pddl> <problem.pddl>\n";
+    std::cout << "Writes the task of every agent (<agent>-domain.pddl and <agent>-problem.pddl).\n";
+    std::cout << "Options:\n";
+    std::cout << "    -h                             -- Print this message.\n";
+    std::cout << "    -d, --output-dir <dir>         -- Output directory (default: current directory).\n";
+    std::cout << "    -t, --threads <n>              -- Number of threads (default: hardware threads).\n";
+    exit( 1 );
+}
+
+int main( int argc, char * argv[] )
+{
+    std::string outputDir = ".";
+    unsigned threads = parser::multiagent::defaultThreads();
+    int i = 1;
+    for ( ; i < argc && argv[i][0] == '-'; ++i ) {
+        if ( ( !strcmp( argv[i], "-d" ) || !strcmp( argv[i], "--output-dir" ) ) && i + 1 < argc ) {
+            outputDir = argv[++i];
+        }
+        else if ( ( !strcmp( argv[i], "-t" ) || !strcmp( argv[i], "--threads" ) ) && i + 1 < argc ) {
+            threads = std::max( 1, atoi( argv[++i] ) );
+        }
+        else {
+            showHelp();
+        }
+    }
+
+    if ( argc != i + 3 ) {
+        showHelp();
+    }
+
+    std::string compiler = argv[i], domain = argv[i + 1], problem = argv[i + 2];
+    std::unique_ptr< Domain > d;
+    if ( compiler == "network" ) {
+        d = std::make_unique< parser::multiagent::MultiagentDomain >( domain );
+    }
+    else if ( compiler == "concurrency" ) {
+        // adds the AGENT type if the domain does not declare it
+        auto cd = std::make_unique< parser::multiagent::ConcurrencyDomain >( domain );
+        parser::multiagent::ConcurrencyCompiler().prepareDomain( *cd );
+        d = std::move( cd );
+    }
+    else {
+        showHelp();
+    }
+
+    Instance ins( *d, problem );
+    parser::multiagent::Projection projection( *d, ins, threads );
+
+    // agents that share a domain also share its text
+    std::map< Domain *, std::string > texts;
+    fs::create_directories( outputDir );
+    for ( const auto & t : projection.tasks ) {
+        std::string & text = texts[t.domain.get()];
+        if ( text.empty() ) {
+            std::ostringstream os;
+            os << *t.domain;
+            text = os.str();
+        }
+
+        std::ofstream df( fs::path( outputDir ) / ( t.agent + "-domain.pddl" ) );
+        std::ofstream pf( fs::path( outputDir ) / ( t.agent + "-problem.pddl" ) );
+        if ( !df || !pf ) {
+            std::cerr << "Failed to write the task of " << t.agent << "\n";
+            return 1;
+        }
+        df << text;
+        pf << *t.instance;
+        std::cout << t.agent << ": " << t.domain->actions.size() << " actions, " << t.instance->init.size() << " initial facts\n";
+    }
+
+    std::cout << "private predicates:";
+    for ( unsigned p = 0; p < d->preds.size(); ++p ) {
+        if ( projection.agentArg[p] >= 0 ) {
+            std::cout << " " << d->preds[p]->name;
+        }
+    }
+    std::cout << "\n" << projection.tasks.size() << " agents, " << texts.size() << " distinct domains\n";
+    return 0;
+}
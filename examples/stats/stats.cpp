@@ -0,0 +1,86 @@
+
+#include <parser/Instance.h>
+#include <multiagent/ConcurrencyCompiler.h>
+#include <multiagent/MultiagentDomain.h>
+#include <multiagent/NetworkCompiler.h>
+#include <multiagent/Statistics.h>
+#include <chrono>
+#include <cstring>
+
+using namespace parser::pddl;
+
+void showHelp() {
+    std::cout << "Usage: ./domain_stats [options] <network|concurrency> <domain.pddl> <problem.pddl>\n";
+    std::cout << "Prints the size of the grounding of a problem and of its compilation without compiling it.\n";
+    std::cout << "Options:\n";
+    std::cout << "    -h                             -- Print this message.\n";
+    std::cout << "    -j, --max-joint-action-size    -- Maximum number of atomic actions per joint action (concurrency).\n";
+    std::cout << "    -o, --use-agent-order          -- Agents do actions in an specific order (concurrency).\n";
+    std::cout << "    -b, --bounded-counters         -- Count actions with bounded propositional counters (network).\n";
+    std::cout << "    -s, --signature                -- Only parse the signature of the domain: sizes are not estimated\n";
+    std::cout << "                                      and the compiled task is not counted.\n";
+    exit( 1 );
+}
+
+int main( int argc, char * argv[] )
+{
+    bool agentOrder = false, boundedCounters = false, signature = false;
+    int maxJointActionSize = -1;
+    int i = 1;
+    for ( ; i < argc && argv[i][0] == '-'; ++i ) {
+        if ( ( !strcmp( argv[i], "-j" ) || !strcmp( argv[i], "--max-joint-action-size" ) ) && i + 1 < argc ) {
+            maxJointActionSize = atoi( argv[++i] );
+        }
+        else if ( !strcmp( argv[i], "-o" ) || !strcmp( argv[i], "--use-agent-order" ) ) {
+            agentOrder = true;
+        }
+        else if ( !strcmp( argv[i], "-b" ) || !strcmp( argv[i], "--bounded-counters" ) ) {
+            boundedCounters = true;
+        }
+        else if ( !strcmp( argv[i], "-s" ) || !strcmp( argv[i], "--signature" ) ) {
+            signature = true;
+        }
+        else {
+            showHelp();
+        }
+    }
+
+    if ( argc != i + 3 ) {
+        showHelp();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::string compiler = argv[i], domain = argv[i + 1], problem = argv[i + 2];
+    parser::multiagent::GroundingSize compiled;
+    std::ostringstream os;
+    if ( compiler == "network" ) {
+        // with -s the conditions of the actions are not parsed, so no action
+        // has effects and every predicate looks static, but there are no
+        // preconditions to filter with either: the estimates are just the
+        // sizes of the grounding by types and are not meaningful
+        parser::multiagent::MultiagentDomain d( domain, 1, signature );
+        Instance ins( d, problem );
+        parser::multiagent::DomainStatistics stats( d, ins );
+        stats.report( os );
+        if ( !signature ) compiled = stats.compiledSize( parser::multiagent::NetworkCompiler( d, true, boundedCounters ) );
+    }
+    else if ( compiler == "concurrency" ) {
+        parser::multiagent::ConcurrencyCompiler cc( agentOrder, maxJointActionSize );
+        parser::multiagent::ConcurrencyDomain d( domain, 1, signature );
+        if ( !signature ) cc.prepareDomain( d );
+        Instance ins( d, problem );
+        parser::multiagent::DomainStatistics stats( d, ins );
+        stats.report( os );
+        if ( !signature ) compiled = stats.compiledSize( cc );
+    }
+    else {
+        showHelp();
+    }
+    double ms = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+
+    std::cout << os.str();
+    if ( signature ) std::cout << "estimates are not meaningful with -s: the conditions of the actions are not parsed\n";
+    if ( !signature ) std::cout << "compiled ground actions (" << compiler << "): " << compiled.naive << ", " << compiled.estimate << " estimated\n";
+    std::cout << "analysis time: " << ms << " ms\n";
+    return 0;
+}
@@ -0,0 +1,40 @@
+
+#pragma once
+
+#include <parser/Instance.h>
+
+#include <multiagent/ConcurrencyDomain.h>
+
+namespace parser { namespace multiagent {
+
+// Compilation of a multiagent domain with concurrency constraints into a
+// classical planning task [Furelos-Blanco and Jonsson, 2019]. Each action is
+// split into SELECT-, DO- and END- actions that respectively select the
+// atomic actions of a joint action, apply them and reset the agents.
+class ConcurrencyCompiler
+{
+public:
+	bool useAgentOrder;     // agents do actions in a specific order
+	int maxJointActionSize; // maximum number of atomic actions per joint action (no limit if not positive)
+	unsigned threads;       // worker threads compiling the actions (the output is the same for any number)
+	bool inlineStatic;      // drop static literals that SELECT- already checks from the concurrency conditions
+
+	ConcurrencyCompiler( bool agentOrder = false, int maxJointSize = -1, unsigned numThreads = 1, bool staticInlining = true )
+		: useAgentOrder( agentOrder ), maxJointActionSize( maxJointSize ), threads( numThreads ), inlineStatic( staticInlining ) {}
+
+	// Parses the conditions of the actions of a lazy domain, adds the AGENT
+	// type (if the domain does not declare it) and, if the agent order is
+	// used, the NOOP action. Must be called before parsing the instances of
+	// the domain.
+	void prepareDomain( ConcurrencyDomain & d ) const;
+
+	std::shared_ptr< pddl::Domain > compileDomain( const ConcurrencyDomain & d ) const;
+
+	// types, functions and predicates of the classical domain without its
+	// actions; enough to compile instances when the domain is not printed
+	std::shared_ptr< pddl::Domain > compileSignature( const ConcurrencyDomain & d ) const;
+
+	std::shared_ptr< pddl::Instance > compileInstance( pddl::Domain & cd, const pddl::Instance & ins ) const;
+};
+
+} } // namespaces
@@ -1,11 +1,17 @@
 
 #pragma once
 
+#include <mutex>
+
 #include <parser/Domain.h>
 
 #include <multiagent/ConcurrentAction.h>
 #include <multiagent/ConcurrencyPredicate.h>
 #include <multiagent/ConcurrencyGround.h>
+#include <multiagent/DeferredBlock.h>
+#include <multiagent/Keywords.h>
+#include <multiagent/LazyBodies.h>
+#include <multiagent/TypeHierarchy.h>
 
 namespace parser { namespace multiagent {
 
@@ -20,15 +26,54 @@ public:
 
 	TokenStruct<std::shared_ptr<ConcurrencyPredicate>> cpreds;	// concurrency predicates
 
-	std::set<std::shared_ptr<ConcurrencyGround>> pendingConcurrencyGrounds;
+	// concurrency grounds waiting for the action they refer to, by action name
+	std::map<std::string, std::vector<std::shared_ptr<ConcurrencyGround>>> pendingConcurrencyGrounds;
+	std::mutex pendingMutex;	// guards pendingConcurrencyGrounds while actions are parsed concurrently
 
-	ConcurrencyDomain()
-		: Base(), multiagent( false ), unfact( false ), fact( false ) {}
+	unsigned parseThreads;	// threads parsing the action blocks
+	std::vector<DeferredBlock> deferredActions;	// action blocks waiting to be parsed by the threads
+
+	bool lazy;	// whether the conditions of the actions are parsed on demand
+	LazyBodies lazyBodies;	// conditions of the actions that were not parsed yet
+
+	std::unique_ptr<TypeHierarchy> hierarchy;	// closure of the types, computed once the domain is parsed
+
+	// keywords of the requirements of multiagent domains and of the heads of
+	// conditions (the enums are in the order of the tables)
+	enum RequirementKeyword { MULTI_AGENT, UNFACTORED_PRIVACY, FACTORED_PRIVACY };
+	static constexpr auto requirementKeywords = keywords( "MULTI-AGENT", "UNFACTORED-PRIVACY", "FACTORED-PRIVACY" );
+
+	enum ConditionKeyword { EQUALS, AND, EXISTS, FORALL, INCREASE, NOT, ONEOF, OR, WHEN };
+	static constexpr auto conditionKeywords = keywords( "=", "AND", "EXISTS", "FORALL", "INCREASE", "NOT", "ONEOF", "OR", "WHEN" );
 
-	ConcurrencyDomain( const std::string& s )
-		: Base(), multiagent( false ), unfact( false ), fact( false )
+	ConcurrencyDomain()
+		: Base(), multiagent( false ), unfact( false ), fact( false ), parseThreads( 1 ), lazy( false ) {}
+
+	// With more than one thread, the action blocks are only copied while the
+	// rest of the domain is parsed, and are then parsed concurrently. Actions
+	// and their concurrency predicates are added in the order of the file, so
+	// the domain is the same as the one parsed on a single thread.
+	//
+	// A lazy domain only parses the names and parameters of the actions; their
+	// conditions are parsed by parsedAction() or parseBodies() (on parseThreads
+	// threads), which must be called before the domain is compiled.
+	ConcurrencyDomain( const std::string& s, unsigned threads = 1, bool lazyConditions = false )
+		: Base(), multiagent( false ), unfact( false ), fact( false ), parseThreads( threads ), lazy( lazyConditions )
 	{
+		lazyBodies.file = s;
 		parse(s);
+		parseDeferredActions( s );
+		hierarchy = std::make_unique<TypeHierarchy>( *this );
+	}
+
+	// Closure of the types of the domain. Instances and compilers add types
+	// and objects, so it is computed again if they changed since it was last
+	// computed (and built on first use in domains that were not parsed).
+	const TypeHierarchy & typeHierarchy()
+	{
+		if ( !hierarchy ) hierarchy = std::make_unique<TypeHierarchy>( *this );
+		else hierarchy->update();
+		return *hierarchy;
 	}
 
 	virtual ~ConcurrencyDomain() override = default;
@@ -44,15 +89,15 @@ public:
 
 	bool parseRequirement( const std::string& s ) override
 	{
-		if (Base::parseRequirement(s)) return true;
-
 		// Parse possible requirements of a multi-agent domain
-		if ( s == "MULTI-AGENT" ) multiagent = true;
-		else if ( s == "UNFACTORED-PRIVACY" ) unfact = true;
-		else if ( s == "FACTORED-PRIVACY" ) fact = true;
-		else return false;
+		switch ( requirementKeywords.find( s ) )
+		{
+			case MULTI_AGENT: multiagent = true; return true;
+			case UNFACTORED_PRIVACY: unfact = true; return true;
+			case FACTORED_PRIVACY: fact = true; return true;
+		}
 
-		return true;
+		return Base::parseRequirement(s);
 	}
 
 	void parseAction( Filereader & f ) override
@@ -63,16 +108,20 @@ public:
 			exit(1);
 		}
 
-		f.next();
 		std::shared_ptr<pddl::Action> a;
+		if ( lazy )
+		{
+			f.next();
+			a = makeAction( f.getToken() );
+			lazyBodies.defer( a, f, *this );
+		}
+		else if ( parseThreads > 1 )
+		{
+			deferredActions.push_back( deferBlock( f ) );
+			return;
+		}
+		else a = parseActionBlock( f );
 
-		// If domain is multiagent, parse using AgentAction
-		if ( multiagent ) a = std::make_shared<ConcurrentAction>( f.getToken() );
-		else a = std::make_shared<pddl::Action>( f.getToken() );
-
-		a->parse( f, types[0]->constants, *this );
-
-		if constexpr ( DOMAIN_DEBUG ) std::cout << a << "\n";
 		actions.insert( a );
 
 		// create a predicate that corresponds to the action being parsed and add it
@@ -80,6 +129,56 @@ public:
 		addConcurrencyPredicateFromAction(*a);
 	}
 
+	std::shared_ptr<pddl::Action> makeAction( const std::string& name ) const
+	{
+		// If domain is multiagent, parse using ConcurrentAction
+		if ( multiagent ) return std::make_shared<ConcurrentAction>( name );
+		else return std::make_shared<pddl::Action>( name );
+	}
+
+	// parses the action block that f is in, right after its keyword
+	std::shared_ptr<pddl::Action> parseActionBlock( Filereader & f )
+	{
+		f.next();
+		auto a = makeAction( f.getToken() );
+		a->parse( f, types[0]->constants, *this );
+
+		if constexpr ( DOMAIN_DEBUG ) std::cout << a << "\n";
+		return a;
+	}
+
+	// Parses the deferred action blocks concurrently. While they are parsed no
+	// concurrency predicate exists yet, so every reference to an action is a
+	// pending concurrency ground, which is resolved when the concurrency
+	// predicates are added below in the order of the actions.
+	void parseDeferredActions( const std::string& file )
+	{
+		std::vector<std::shared_ptr<pddl::Action>> parsed( deferredActions.size() );
+		parseDeferred( file, deferredActions, parseThreads, [&]( Filereader& f, unsigned i ) {
+			parsed[i] = parseActionBlock( f );
+		} );
+		deferredActions.clear();
+
+		for (const auto& a : parsed)
+		{
+			actions.insert( a );
+			addConcurrencyPredicateFromAction( *a );
+		}
+	}
+
+	// action i, with its conditions parsed if the domain is lazy
+	const std::shared_ptr<pddl::Action>& parsedAction( unsigned i )
+	{
+		lazyBodies.parse( actions[i]->name, *this );
+		return actions[i];
+	}
+
+	// parses the conditions of all actions of a lazy domain that were not parsed yet
+	void parseBodies()
+	{
+		lazyBodies.parseAll( *this, parseThreads );
+	}
+
 	void addConcurrencyPredicateFromAction(const pddl::Action& a )
 	{
 		auto cp = std::make_shared<ConcurrencyPredicate>( a.name );
@@ -87,13 +186,13 @@ public:
 		preds.insert( cp );
 		cpreds.insert( cp );
 
-		//
-		for (const auto& pendingConcurrencyGround : pendingConcurrencyGrounds)
+		// resolve the grounds that were waiting for this action
+		auto pending = pendingConcurrencyGrounds.find( a.name );
+		if ( pending != pendingConcurrencyGrounds.end() )
 		{
-			std::string groundName = pendingConcurrencyGround->name;
-			if ( groundName == a.name ) {
+			for (const auto& pendingConcurrencyGround : pending->second)
 				pendingConcurrencyGround->setLifted( cp, *this );
-			}
+			pendingConcurrencyGrounds.erase( pending );
 		}
 	}
 
@@ -193,15 +292,18 @@ public:
 	{
 		std::string s = f.getToken();
 
-		if ( s == "=" ) return std::make_shared<pddl::Equals>();
-		if ( s == "AND" ) return std::make_shared<pddl::And>();
-		if ( s == "EXISTS" ) return std::make_shared<pddl::Exists>();
-		if ( s == "FORALL" ) return std::make_shared<pddl::Forall>();
-		if ( s == "INCREASE" ) return std::make_shared<pddl::Increase>();
-		if ( s == "NOT" ) return std::make_shared<pddl::Not>();
-		if ( s == "ONEOF" ) return std::make_shared<pddl::Oneof>();
-		if ( s == "OR" ) return std::make_shared<pddl::Or>();
-		if ( s == "WHEN" ) return std::make_shared<pddl::When>();
+		switch ( conditionKeywords.find( s ) )
+		{
+			case EQUALS: return std::make_shared<pddl::Equals>();
+			case AND: return std::make_shared<pddl::And>();
+			case EXISTS: return std::make_shared<pddl::Exists>();
+			case FORALL: return std::make_shared<pddl::Forall>();
+			case INCREASE: return std::make_shared<pddl::Increase>();
+			case NOT: return std::make_shared<pddl::Not>();
+			case ONEOF: return std::make_shared<pddl::Oneof>();
+			case OR: return std::make_shared<pddl::Or>();
+			case WHEN: return std::make_shared<pddl::When>();
+		}
 
 		int i = preds.index( s );
 		if ( i >= 0 ) 
@@ -213,7 +315,8 @@ public:
 			// they are saved to be assigned later a Lifted predicate
 			// each time an action is parsed
 			auto cg = std::make_shared<ConcurrencyGround>(s);
-			pendingConcurrencyGrounds.insert( cg );
+			std::lock_guard<std::mutex> lock( pendingMutex );
+			pendingConcurrencyGrounds[s].push_back( cg );
 			return cg;
 		}
 
@@ -29,6 +29,12 @@ public:
 	void parse( Filereader & f, TokenStruct< std::string > & ts, pddl::Domain & d) override;
 
 	void setLifted(const std::shared_ptr<pddl::Lifted>& l, pddl::Domain & d );
+
+	// copies keep the constants (Ground::copy would drop them)
+	[[nodiscard]] std::shared_ptr<pddl::Condition> copy(const pddl::Domain& d) const override
+	{
+		return std::make_shared<ConcurrencyGround>(*this);
+	}
 };
 
 } } // namespaces
@@ -27,6 +27,9 @@ public:
 	void PDDLPrint(std::ostream& s, unsigned indent, const TokenStruct<std::string>& ts, const pddl::Domain& d) const override;
 
 	void parse(Filereader& f, TokenStruct<std::string>& ts, pddl::Domain& d) override;
+
+	// parses the agent and the parameters, and returns their names and types
+	TokenStruct<std::string> parseHeader(Filereader& f, pddl::Domain& d);
 };
 
 } } // namespaces
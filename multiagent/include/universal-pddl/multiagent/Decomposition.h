@@ -0,0 +1,50 @@
+
+#pragma once
+
+#include <parser/Instance.h>
+
+namespace parser { namespace multiagent {
+
+// Decomposition of a multiagent instance into subproblems whose agents never
+// interact. Two agents interact if they are connected through the objects of
+// the initial state and the goal. This is only sound if every action keeps
+// the facts of each component inside it, which is checked on the actions of
+// the domain: all parameters must be related to the agent by positive
+// preconditions, added facts may only mention parameters and read or deleted
+// fluents must mention at least one. If some action (or a concurrency
+// constraint without parameters) breaks this, the instance is not decomposed.
+class Decomposition
+{
+public:
+	struct Subproblem
+	{
+		StringVec agents;
+		std::vector< std::pair< std::string, std::string > > objects; // name and type
+		pddl::GroundVec init, goal;
+	};
+
+	const pddl::Domain & d;
+	const pddl::Instance & ins;
+
+	std::vector< Subproblem > subproblems;
+	std::string reason; // why the instance was not decomposed (empty if it was)
+
+	Decomposition( const pddl::Domain & dom, const pddl::Instance & instance );
+
+	// prints subproblem k as a problem of the domain of the instance
+	void PDDLPrint( std::ostream & os, unsigned k ) const;
+};
+
+// Joint plans as written by compress ("<step>: <action>" lines): the
+// actions done at each step.
+typedef std::vector< StringVec > JointPlan;
+
+JointPlan readPlan( std::istream & is );
+
+void printPlan( std::ostream & os, const JointPlan & plan );
+
+// plans of independent subproblems can be executed at the same time, so
+// step t of the merged plan does step t of every plan
+JointPlan mergePlans( const std::vector< JointPlan > & plans );
+
+} } // namespaces
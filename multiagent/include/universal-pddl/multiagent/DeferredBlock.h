@@ -0,0 +1,39 @@
+
+#pragma once
+
+#include <functional>
+
+#include <parser/Filereader.h>
+
+namespace parser { namespace multiagent {
+
+// Block of a domain file whose parsing is postponed so that blocks that do
+// not depend on each other (such as actions) can be parsed concurrently once
+// the rest of the domain is known. The block is not copied: it keeps where
+// it starts in the file, so that it is parsed again from the file itself.
+struct DeferredBlock
+{
+	unsigned row, col; // position in the file of the text after the block keyword
+	std::string line;  // line of the file at row
+	std::streamoff next; // offset in the file of the line after row (-1 if row is the last line)
+};
+
+// Records where the rest of the block that f is in (right after its keyword)
+// starts, and moves f past the closing parenthesis of the block by matching
+// parentheses. Parentheses in comments are not counted.
+DeferredBlock deferBlock( pddl::Filereader & f );
+
+// moves f, a reader on the domain file of block b, to the start of b (which
+// must not be before the position of f)
+void moveTo( pddl::Filereader & f, const DeferredBlock & b );
+
+// Calls parse( g, i ) for every block i of the domain file on at most
+// `threads` threads. The blocks must be in the order in which they are in
+// the file. Each thread takes consecutive blocks and opens its own reader g
+// on the file, which it moves to the start of each block, so g reports
+// errors at their positions in the domain file. parse starts right after the
+// keyword of block i and must read the block up to its closing parenthesis;
+// it is called for the blocks of a thread in increasing order.
+void parseDeferred( const std::string & file, const std::vector< DeferredBlock > & blocks, unsigned threads, const std::function< void( pddl::Filereader &, unsigned ) > & parse );
+
+} } // namespaces
@@ -0,0 +1,85 @@
+
+#pragma once
+
+#include <parser/Instance.h>
+
+#include <multiagent/FactTable.h>
+
+namespace parser { namespace multiagent {
+
+// Changes of the initial state and the goal of an instance. A delta is read
+// and printed as a patch with one change per line:
+//
+//   + init (AT A1 LOC2X4)
+//   - goal (AT A1 LOC2X3)
+//
+// Deltas only change facts of predicates; they cannot add objects or change
+// the values of functions.
+class InstanceDelta
+{
+public:
+	struct Change
+	{
+		bool add;  // add (true) or remove (false) the fact
+		bool goal; // fact of the goal (true) or of the initial state (false)
+		std::string name;
+		StringVec params;
+	};
+
+	std::vector< Change > changes;
+
+	void addInit( const std::string & name, const StringVec & params = StringVec() );
+	void removeInit( const std::string & name, const StringVec & params = StringVec() );
+	void addGoal( const std::string & name, const StringVec & params = StringVec() );
+	void removeGoal( const std::string & name, const StringVec & params = StringVec() );
+
+	// reads the changes of a patch (names are case-insensitive, as in PDDL)
+	void read( std::istream & is );
+
+	void print( std::ostream & os ) const;
+};
+
+// Instance whose facts are indexed so that a delta is applied in time
+// proportional to its size, without parsing or printing the whole instance
+// again. The facts are indexed by their ids in a FactTable, so the index
+// keeps no names.
+//
+// The same delta can be applied to an instance and to its compilation, since
+// both compilers copy the initial facts and the goals of the predicates of
+// the multiagent domain unchanged: changes on predicates that the domain of
+// the instance does not have, or on names that are not objects of the types
+// of the parameters, are ignored. Changes are resolved without changing the
+// instance, and only added facts enter the table. Facts that a compiler derives from
+// the whole problem (the SYM-PREV facts of symmetry breaking, or the facts
+// removed by dead code elimination) are not updated, so such compilations
+// must be compiled again.
+class IncrementalInstance
+{
+public:
+	pddl::Instance & ins;
+
+	IncrementalInstance( pddl::Instance & instance );
+
+	// Applies the delta to the instance and returns the changes that had an
+	// effect (facts that were not there before being added, or were there
+	// before being removed), which is the delta to apply to the compiled
+	// instance. The order of the facts of the instance is not kept.
+	InstanceDelta apply( const InstanceDelta & delta );
+
+private:
+	FactTable facts;
+	IntVec init, goal; // position of each fact of the table in ins.init and ins.goal (-1 if it is not there)
+
+	// id of fact g, which is added to the table if it is new
+	unsigned fact( const pddl::Ground & g );
+
+	// ids of the objects named by the parameters of a fact of predicate p,
+	// or false if there are not as many as parameters or one of them is not
+	// an object of the type of its parameter
+	bool objects( int p, const StringVec & names, IntVec & params ) const;
+
+	// removes the fact at position i of v by moving the last fact to it
+	void erase( pddl::GroundVec & v, IntVec & index, unsigned i );
+};
+
+} } // namespaces
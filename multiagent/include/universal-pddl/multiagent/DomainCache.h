@@ -0,0 +1,41 @@
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace parser { namespace multiagent {
+
+// On-disk cache of compiled classical domains. Entries are addressed by a
+// hash of the multiagent domain file, the compiler and its options, so that
+// editing the domain or changing the options never returns a stale entry.
+// The least recently used entries are removed when the total size of the
+// cache exceeds its limit. Several processes may share the same directory.
+class DomainCache
+{
+public:
+	// bumped whenever the output of the compilers changes, invalidating all entries
+	static constexpr unsigned FORMAT = 1;
+
+	std::string dir;
+	std::uintmax_t maxBytes;
+
+	DomainCache( const std::string & directory, std::uintmax_t limit = 256u << 20 );
+
+	// key of the domain compiled with the given compiler name and options
+	static std::string key( const std::string & domainFile, const std::string & compiler, const std::string & options );
+
+	// returns true and fills text with the cached domain if there is an entry
+	bool lookup( const std::string & key, std::string & text ) const;
+
+	// stores the domain and evicts old entries if the cache is too large
+	void store( const std::string & key, const std::string & text ) const;
+
+	// removes all the entries of the cache
+	void clear() const;
+
+	// removes least recently used entries until the cache fits its limit
+	void evict() const;
+};
+
+} } // namespaces
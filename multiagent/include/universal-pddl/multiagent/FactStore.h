@@ -0,0 +1,101 @@
+
+#pragma once
+
+#include <functional>
+#include <span>
+
+#include <parser/Instance.h>
+
+namespace parser { namespace multiagent {
+
+// Facts of one predicate stored by columns: the objects at each argument
+// position are in a contiguous array, so a scan that reads one position
+// touches only that array. After index() each position also has an index
+// from objects to the rows that have them, built with a counting sort.
+// Objects are the global ids of a FactStore (never negative).
+class PredicateColumns
+{
+public:
+	explicit PredicateColumns( unsigned arity = 0 ) : columns( arity ), count( 0 ) {}
+
+	unsigned arity() const { return columns.size(); }
+	unsigned size() const { return count; }
+
+	// appends a row; the indexes must be built again before they are used
+	void add( std::span< const int > args );
+
+	int at( unsigned row, unsigned pos ) const { return columns[pos][row]; }
+
+	std::span< const int > column( unsigned pos ) const { return columns[pos]; }
+
+	// builds the index of every position for objects 0, ..., objects - 1
+	void index( unsigned objects );
+
+	bool indexed() const { return indexes.size() == columns.size() && count > 0; }
+
+	// rows that have the object at position pos (the index must be built)
+	std::span< const unsigned > rows( unsigned pos, int object ) const;
+
+	// rows whose objects are those of pattern, where -1 matches any object
+	UnsignedVec match( std::span< const int > pattern ) const;
+
+	// upper bound of the number of rows that match pattern
+	unsigned estimate( std::span< const int > pattern ) const;
+
+private:
+	struct Index
+	{
+		UnsignedVec starts; // position in rows of the rows of each object (and the end of the last)
+		UnsignedVec rows;
+	};
+
+	std::vector< IntVec > columns;
+	std::vector< Index > indexes;
+	unsigned count;
+};
+
+// Atom of a conjunctive query: arguments that are not negative are variables,
+// and a negative argument a is the object -1 - a.
+struct JoinAtom
+{
+	int pred;
+	IntVec args;
+};
+
+// Facts of the initial state of an instance with one PredicateColumns per
+// predicate of the domain. Objects and constants get global ids, so columns
+// of predicates with different parameter types can be joined.
+class FactStore
+{
+public:
+	FactStore( const pddl::Domain & d, const pddl::Instance & ins );
+
+	unsigned objects() const { return names.size(); }
+	const std::string & object( int id ) const { return names[id]; }
+
+	// id of the object or constant, or -1 if there is none
+	int objectId( const std::string & s ) const;
+
+	const PredicateColumns & facts( int pred ) const { return tables[pred]; }
+
+	// query atom of a literal of an action: the parameters of the action are
+	// variables and constants are objects
+	JoinAtom atom( const pddl::Ground & g ) const;
+
+	// Calls f with the objects of variables 0, ..., vars - 1 for each binding
+	// under which all atoms are facts; variables not in any atom are -1. Atoms
+	// are matched one at a time, each time the one with the fewest candidate
+	// rows under the current binding.
+	void join( const std::vector< JoinAtom > & atoms, unsigned vars, const std::function< void( std::span< const int > ) > & f ) const;
+
+private:
+	const pddl::Domain & d;
+	StringVec names;
+	std::map< std::string, int > ids;
+	std::vector< PredicateColumns > tables;
+
+	void join( const std::vector< JoinAtom > & atoms, std::vector< bool > & done, IntVec & binding,
+	           const std::function< void( std::span< const int > ) > & f ) const;
+};
+
+} } // namespaces
@@ -0,0 +1,70 @@
+
+#pragma once
+
+#include <span>
+#include <unordered_map>
+
+#include <parser/Instance.h>
+
+namespace parser { namespace multiagent {
+
+// Hash-consed ground atoms: each distinct (predicate, objects) tuple is kept
+// once and gets a dense id, with the objects of all atoms in one array. The
+// ids of the objects are those of pddl::Ground (positions in the types of the
+// parameters of the predicate, negative for constants).
+class FactTable
+{
+public:
+	FactTable() : starts( 1, 0 ) {}
+
+	// id of the atom, which is added if it is not in the table
+	unsigned insert( int pred, std::span< const int > args );
+
+	// id of the atom, or -1 if it is not in the table
+	int find( int pred, std::span< const int > args ) const;
+
+	int pred( unsigned id ) const { return preds[id]; }
+
+	std::span< const int > args( unsigned id ) const
+	{
+		return std::span< const int >( pool.data() + starts[id], starts[id + 1] - starts[id] );
+	}
+
+	unsigned size() const { return preds.size(); }
+
+private:
+	IntVec preds, pool;
+	UnsignedVec starts; // position in pool of the objects of each atom (and the end of the last)
+	std::unordered_multimap< size_t, unsigned > index; // ids by hash
+
+	static size_t hash( int pred, std::span< const int > args );
+};
+
+// Copies ground atoms of the instances of a domain to the instances of
+// another one (such as a compiled domain) by id: the predicates of both
+// domains are matched by name once, and the ids of the objects are kept when
+// the types of the parameters have the same objects in the same order, so
+// no object is turned into its name and parsed again. Atoms of predicates
+// whose objects have different ids are copied through their names.
+class FactCopier
+{
+public:
+	FactCopier( const pddl::Domain & from, pddl::Domain & to );
+
+	// Append the copy of atom g of `from` to the initial state (the goal) of
+	// ins, an instance of `to`. They return false, and copy nothing, if `to`
+	// does not have the predicate of g.
+	bool copyInit( const pddl::Ground & g, pddl::Instance & ins ) const;
+	bool copyGoal( const pddl::Ground & g, pddl::Instance & ins ) const;
+
+private:
+	const pddl::Domain & from;
+	pddl::Domain & to;
+
+	IntVec preds;                 // predicate of `to` for each predicate of `from` (-1 if none)
+	std::vector< bool > sameIds;  // whether the objects of each predicate have the same ids in both domains
+
+	bool copy( const pddl::Ground & g, pddl::Instance & ins, bool goal ) const;
+};
+
+} } // namespaces
@@ -0,0 +1,127 @@
+
+#pragma once
+
+#include <span>
+
+#include <parser/Domain.h>
+
+namespace parser { namespace multiagent {
+
+// Immutable copy of a parsed domain in which every element is in a flat
+// array and refers to the others by index: there are no shared or weak
+// pointers to follow (or to count) while it is read, so a frozen domain can
+// be read by any number of threads at the same time. Names are kept only
+// once, in the element they name.
+//
+// Elements that have a variable number of parts (the parameters of a
+// predicate, the children of a condition, ...) keep a Range of a shared
+// array of parts.
+class FrozenDomain
+{
+public:
+	struct Range
+	{
+		unsigned first = 0, size = 0;
+	};
+
+	struct Type
+	{
+		std::string name;
+		int supertype;   // -1 for the root type
+		Range constants; // in constants
+	};
+
+	// predicate, function or action signature
+	struct Symbol
+	{
+		std::string name;
+		Range params; // types of the parameters, in params
+		bool concurrency = false; // concurrency predicate (predicate of a ConcurrencyDomain that is an action)
+	};
+
+	enum Kind { GROUND, EQUALS, NOT, AND, OR, ONEOF, FORALL, EXISTS, WHEN, INCREASE };
+
+	// child of a node whose operand is missing (such as a WHEN without condition)
+	static constexpr unsigned none = ~0u;
+
+	// Node of a condition. The arguments of GROUND and EQUALS are those of
+	// pddl::Ground (parameters of the action are non-negative, constants are
+	// negative), and those of FORALL and EXISTS are the types of their
+	// variables. NOT, FORALL and EXISTS have one child, WHEN has the condition
+	// and the effect, and OR has its two operands; a missing operand is none,
+	// so the position of each child is fixed. AND and ONEOF have their
+	// operands. INCREASE has no children: the parser keeps its operands as an
+	// expression tree, so it is kept as PDDL text in increases, with the
+	// variables in scope (the parameters of the action and then those of the
+	// enclosing quantifiers) named ?0, ?1, ...
+	struct Node
+	{
+		Kind kind;
+		int symbol = -1; // predicate of GROUND, text in increases of INCREASE
+		Range args;      // in args
+		Range children;  // in children
+	};
+
+	struct Action
+	{
+		Symbol signature;
+		int pre = -1, eff = -1; // root nodes of the precondition and the effect (-1 if there is none)
+	};
+
+	struct Template
+	{
+		int action;
+		Range args; // parameters of the network node that are those of the action, in args
+	};
+
+	struct NetworkNode
+	{
+		Symbol signature;
+		unsigned lower, upper;
+		Range templates; // in templates
+	};
+
+	std::string name;
+	bool typed, multiagent, unfact, fact, net;
+
+	std::vector< Type > types;
+	std::vector< Symbol > preds, funcs;
+	std::vector< Action > actions;
+	std::vector< Node > nodes; // nodes of all conditions, each one after its children
+	std::vector< NetworkNode > network;
+	PairVec edges;
+
+	// parts of the elements above
+	StringVec constants;
+	IntVec params, args;
+	UnsignedVec children;
+	std::vector< Template > templates;
+	StringVec increases;
+
+	// parts of an element, such as part( params, preds[i].params )
+	template < typename T >
+	static std::span< const T > part( const std::vector< T > & parts, Range r )
+	{
+		return std::span< const T >( parts.data() + r.first, r.size );
+	}
+
+	int typeIndex( const std::string & s ) const;
+	int predIndex( const std::string & s ) const;
+	int actionIndex( const std::string & s ) const;
+
+	// whether type t is type u or one of its subtypes
+	bool subtype( int t, int u ) const;
+
+private:
+	friend std::shared_ptr< const FrozenDomain > freeze( const pddl::Domain & d, bool signature );
+
+	std::map< std::string, int > typeIndices, predIndices, actionIndices;
+};
+
+// Frozen copy of d, which can be a MultiagentDomain, a ConcurrencyDomain or a
+// classical domain. The conditions of the actions of a lazy domain must have
+// been parsed, unless only its signature is frozen: then the conditions that
+// were not parsed are missing (their root is -1).
+std::shared_ptr< const FrozenDomain > freeze( const pddl::Domain & d, bool signature = false );
+
+} } // namespaces
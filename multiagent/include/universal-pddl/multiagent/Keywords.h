@@ -0,0 +1,69 @@
+
+#pragma once
+
+#include <array>
+#include <bit>
+#include <string_view>
+
+namespace parser { namespace multiagent {
+
+// FNV-1a hash of s, starting from the given seed
+constexpr unsigned keywordHash( std::string_view s, unsigned seed )
+{
+	unsigned h = 2166136261u ^ seed;
+	for ( char c : s ) h = ( h ^ static_cast< unsigned char >( c ) ) * 16777619u;
+	return h;
+}
+
+// Perfect hash table of N keywords, built at compile time: the seed of the
+// hash is chosen so that no two keywords fall in the same slot, so finding a
+// token takes one hash and one comparison. Keywords are numbered in the order
+// in which they are given, so a parser declares an enum in the same order and
+// dispatches with a switch on find(). A subclass of a parser adds keywords
+// with a table of its own, which it looks up before calling its base class.
+template < size_t N >
+class KeywordTable
+{
+public:
+	static constexpr size_t slots = std::bit_ceil( 2 * N );
+
+	constexpr KeywordTable( const std::array< std::string_view, N > & keywords )
+		: words( keywords ), table(), seed( 0 )
+	{
+		while ( !build() )
+			if ( ++seed == 1u << 16 ) throw "repeated keywords";
+	}
+
+	// number of keyword s, or -1 if s is not a keyword
+	constexpr int find( std::string_view s ) const
+	{
+		int k = table[keywordHash( s, seed ) & ( slots - 1 )];
+		return k >= 0 && words[k] == s ? k : -1;
+	}
+
+	constexpr size_t size() const { return N; }
+
+private:
+	std::array< std::string_view, N > words;
+	std::array< int, slots > table; // keyword in each slot, or -1
+	unsigned seed;
+
+	constexpr bool build()
+	{
+		table.fill( -1 );
+		for ( unsigned i = 0; i < N; ++i ) {
+			int & slot = table[keywordHash( words[i], seed ) & ( slots - 1 )];
+			if ( slot >= 0 ) return false;
+			slot = i;
+		}
+		return true;
+	}
+};
+
+template < typename... T >
+constexpr KeywordTable< sizeof...( T ) > keywords( const T &... words )
+{
+	return KeywordTable< sizeof...( T ) >( { std::string_view( words )... } );
+}
+
+} } // namespaces
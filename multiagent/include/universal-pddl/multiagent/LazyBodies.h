@@ -0,0 +1,54 @@
+
+#pragma once
+
+#include <parser/Domain.h>
+
+#include <multiagent/DeferredBlock.h>
+
+namespace parser { namespace multiagent {
+
+// Conditions of the actions of a domain that are parsed on demand. Tools that
+// only need the signature of a domain (requirements, types, predicates, the
+// names and parameters of the actions and the concurrency network) skip the
+// preconditions and effects, which are most of the parsing time of large
+// domains. Until its conditions are parsed, the pre and eff of an action are
+// null.
+class LazyBodies
+{
+public:
+	std::string file; // domain file, from which the conditions are parsed
+
+	// Parses the agent and parameters of action a (right after its name) and
+	// records where the rest of its block, which holds the conditions, starts.
+	void defer( const std::shared_ptr< pddl::Action > & a, pddl::Filereader & f, pddl::Domain & d );
+
+	bool empty() const { return bodies.empty(); }
+
+	// whether the conditions of the action with the given name were not parsed yet
+	bool pending( const std::string & action ) const { return bodies.contains( action ); }
+
+	// parses the conditions of one action (nothing if they were already parsed)
+	void parse( const std::string & action, pddl::Domain & d );
+
+	// parses the conditions of all actions on at most `threads` threads
+	void parseAll( pddl::Domain & d, unsigned threads );
+
+private:
+	struct Body
+	{
+		std::shared_ptr< pddl::Action > action;
+		pddl::TokenStruct< std::string > params; // names and types of the parameters of the action
+		DeferredBlock block;
+	};
+
+	std::map< std::string, Body > bodies; // by action name
+};
+
+// Stops with an error if d is a lazy domain (MultiagentDomain or
+// ConcurrencyDomain) with actions whose conditions were not parsed yet.
+// Steps that read the conditions of the actions call it first, so that they
+// do not take unparsed actions for actions without conditions; `step` names
+// the step in the message.
+void requireParsedConditions( const pddl::Domain & d, const std::string & step );
+
+} } // namespaces
@@ -0,0 +1,34 @@
+
+#pragma once
+
+#include <parser/Instance.h>
+
+namespace parser { namespace multiagent {
+
+// Backward relevance analysis of a compiled classical task. A predicate is
+// live if it appears in the goal or is read (in a precondition or in the
+// condition of a conditional effect) by a relevant action, and an action is
+// relevant if it adds or deletes a live predicate. Irrelevant actions can be
+// removed from any plan without making it invalid, so eliminating them, the
+// effects on dead predicates and the dead predicates themselves keeps the
+// plans of the task (restricted to the remaining actions) unchanged.
+class Liveness
+{
+public:
+	std::set< std::string > live;                       // names of the live predicates
+	unsigned actionsBefore, actionsAfter;               // number of actions
+	unsigned predicatesBefore, predicatesAfter;         // number of predicates
+	unsigned initBefore, initAfter;                     // number of initial facts
+
+	// computes the live predicates of cd for the goal of cins
+	Liveness( const pddl::Domain & cd, const pddl::Instance & cins );
+
+	// removes the irrelevant actions, the effects on dead predicates and
+	// the dead predicates from cd, and their initial facts from cins
+	void eliminate( pddl::Domain & cd, pddl::Instance & cins );
+
+	// prints the reduction of the task
+	void report( std::ostream & os ) const;
+};
+
+} } // namespaces
@@ -5,6 +5,9 @@
 
 #include <multiagent/NetworkNode.h>
 #include <multiagent/AgentAction.h>
+#include <multiagent/DeferredBlock.h>
+#include <multiagent/Keywords.h>
+#include <multiagent/LazyBodies.h>
 
 namespace parser { namespace multiagent {
 
@@ -30,40 +33,71 @@ public:
 
 	UnsignedVec mf;                     // merge-find for connected components
 
+	unsigned parseThreads = 1;                      // threads parsing the action and constraint blocks
+	std::vector<DeferredBlock> deferredActions, deferredNodes, deferredEdges; // blocks waiting to be parsed
+
+	bool lazy = false;                              // whether the conditions of the actions are parsed on demand
+	LazyBodies lazyBodies;                          // conditions of the actions that were not parsed yet
+
+	// keywords of the blocks and requirements of multiagent domains (the
+	// enums are in the order of the tables)
+	enum BlockKeyword { CONCURRENCY_CONSTRAINT, POSITIVE_DEPENDENCE };
+	static constexpr auto blockKeywords = keywords( "CONCURRENCY-CONSTRAINT", "POSITIVE-DEPENDENCE" );
+
+	enum RequirementKeyword { MULTI_AGENT, UNFACTORED_PRIVACY, FACTORED_PRIVACY, CONCURRENCY_NETWORK };
+	static constexpr auto requirementKeywords = keywords( "MULTI-AGENT", "UNFACTORED-PRIVACY", "FACTORED-PRIVACY", "CONCURRENCY-NETWORK" );
+
 	MultiagentDomain() = default;
 
-	MultiagentDomain(const std::string& s) :
+	// With more than one thread, the blocks of actions, concurrency constraints
+	// and dependences are only copied while the rest of the domain is parsed.
+	// The actions are then parsed concurrently, followed by the constraints
+	// (which refer to the actions), and both are added in the order of the
+	// file, so the domain is the same as the one parsed on a single thread.
+	//
+	// A lazy domain only parses the names and parameters of the actions; their
+	// conditions are parsed by parsedAction() or parseBodies() (on parseThreads
+	// threads), which must be called before the domain is compiled.
+	MultiagentDomain(const std::string& s, unsigned threads = 1, bool lazyConditions = false) :
 		Base(),
-		multiagent(false), unfact(false), fact(false), net(false)
+		multiagent(false), unfact(false), fact(false), net(false), parseThreads(threads), lazy(lazyConditions)
 	{
+		lazyBodies.file = s;
 		parse(s);
+		parseDeferredBlocks( s );
 	}
 
 	~MultiagentDomain() override = default;
 	
 	bool parseBlock(const std::string& t, Filereader& f) override
 	{
-		if (Base::parseBlock(t, f)) return true;
-		
-		if (t == "CONCURRENCY-CONSTRAINT") parseNetworkNode(f);
-		else if (t == "POSITIVE-DEPENDENCE") parseNetworkEdge(f);
-		else return false; // Unknown block type
-		
-		return true;
+		switch (blockKeywords.find(t))
+		{
+			case CONCURRENCY_CONSTRAINT:
+				if (parseThreads > 1) deferredNodes.push_back(deferBlock(f));
+				else parseNetworkNode(f);
+				return true;
+			case POSITIVE_DEPENDENCE:
+				if (parseThreads > 1) deferredEdges.push_back(deferBlock(f));
+				else parseNetworkEdge(f);
+				return true;
+		}
+
+		return Base::parseBlock(t, f);
 	}
 	
 	bool parseRequirement(const std::string& s) override
 	{
-		if (Base::parseRequirement(s)) return true;
-		
 		// Parse possible requirements of a multi-agent domain
-		if ( s == "MULTI-AGENT" ) multiagent = true;
-		else if ( s == "UNFACTORED-PRIVACY" ) unfact = true;
-		else if ( s == "FACTORED-PRIVACY" ) fact = true;
-		else if ( s == "CONCURRENCY-NETWORK" ) net = true;
-		else return false; // Unknown requirement
-		
-		return true;
+		switch (requirementKeywords.find(s))
+		{
+			case MULTI_AGENT: multiagent = true; return true;
+			case UNFACTORED_PRIVACY: unfact = true; return true;
+			case FACTORED_PRIVACY: fact = true; return true;
+			case CONCURRENCY_NETWORK: net = true; return true;
+		}
+
+		return Base::parseRequirement(s);
 	}
 	
 	void parseAction(Filereader& f) override
@@ -74,20 +108,56 @@ public:
 			exit(1);
 		}
 
-		f.next();
-		std::shared_ptr<pddl::Action> a;
+		if ( lazy )
+		{
+			f.next();
+			auto a = makeAction( f.getToken() );
+			lazyBodies.defer( a, f, *this );
+			actions.insert( a );
+		}
+		else if ( parseThreads > 1 ) deferredActions.push_back( deferBlock( f ) );
+		else actions.insert( parseActionBlock( f ) );
+	}
 
+	std::shared_ptr<pddl::Action> makeAction(const std::string& name) const
+	{
 		// If domain is multiagent, parse using AgentAction
-		if ( multiagent ) a = std::make_shared<AgentAction>( f.getToken() );
-		else a = std::make_shared<pddl::Action>( f.getToken() );
+		if ( multiagent ) return std::make_shared<AgentAction>( name );
+		else return std::make_shared<pddl::Action>( name );
+	}
 
+	// parses the action block that f is in, right after its keyword
+	std::shared_ptr<pddl::Action> parseActionBlock(Filereader& f)
+	{
+		f.next();
+		auto a = makeAction( f.getToken() );
 		a->parse( f, types[0]->constants, *this );
 
 		if constexpr ( DOMAIN_DEBUG ) std::cout << a << "\n";
-		actions.insert( a );
+		return a;
 	}
 	
+	// action i, with its conditions parsed if the domain is lazy
+	const std::shared_ptr<pddl::Action>& parsedAction(unsigned i)
+	{
+		lazyBodies.parse( actions[i]->name, *this );
+		return actions[i];
+	}
+
+	// parses the conditions of all actions of a lazy domain that were not parsed yet
+	void parseBodies()
+	{
+		lazyBodies.parseAll( *this, parseThreads );
+	}
+
 	void parseNetworkNode(Filereader& f)
+	{
+		nodes.insert( parseNodeBlock( f ) );
+		mf.emplace_back(mf.size());
+	}
+
+	// parses the concurrency constraint block that f is in, right after its keyword
+	std::shared_ptr<NetworkNode> parseNodeBlock(Filereader& f)
 	{
 		if (preds.empty() || actions.empty()) 
 		{
@@ -100,9 +170,37 @@ public:
 		n->parse( f, types[0]->constants, *this );
 
 		if constexpr ( DOMAIN_DEBUG ) std::cout << n << "\n";
+		return n;
+	}
 
-		nodes.insert( n );
-		mf.emplace_back(mf.size());
+	// parses the deferred blocks from the domain file they are in
+	void parseDeferredBlocks( const std::string& file )
+	{
+		std::vector<std::shared_ptr<pddl::Action>> parsedActions( deferredActions.size() );
+		parseDeferred( file, deferredActions, parseThreads, [&]( Filereader& f, unsigned i ) {
+			parsedActions[i] = parseActionBlock( f );
+		} );
+		for (const auto& a : parsedActions)
+			actions.insert( a );
+
+		std::vector<std::shared_ptr<NetworkNode>> parsedNodes( deferredNodes.size() );
+		parseDeferred( file, deferredNodes, parseThreads, [&]( Filereader& f, unsigned i ) {
+			parsedNodes[i] = parseNodeBlock( f );
+		} );
+		for (const auto& n : parsedNodes)
+		{
+			nodes.insert( n );
+			mf.emplace_back(mf.size());
+		}
+
+		// dependences are short and refer to the constraints, so they are parsed last on one thread
+		parseDeferred( file, deferredEdges, 1, [&]( Filereader& f, unsigned ) {
+			parseNetworkEdge( f );
+		} );
+
+		deferredActions.clear();
+		deferredNodes.clear();
+		deferredEdges.clear();
 	}
 
 	void parseNetworkEdge(Filereader& f)
@@ -0,0 +1,59 @@
+
+#pragma once
+
+#include <parser/Instance.h>
+
+#include <multiagent/MultiagentDomain.h>
+
+namespace parser { namespace multiagent {
+
+// Compilation of a multiagent domain with a concurrency network into a
+// classical planning task [Crosby, Jonsson and Rovatsos, 2014].
+// The classical domain only depends on the multiagent domain, so it can be
+// created once and shared by all the instances of the domain.
+class NetworkCompiler
+{
+public:
+	typedef std::map< unsigned, std::vector< int > > VecMap;
+
+	const MultiagentDomain & d;
+	bool inlineStatic; // add the static preconditions of the actions of a node to its START- action
+	bool boundedCounters; // count the actions of a node with propositional counters up to counterBound
+	bool symmetryBreaking; // interchangeable agents (see AgentSymmetry) start acting in a fixed order
+
+	std::set< unsigned > prob; // problematic fluents (preconditions deleted by agents)
+	std::set< unsigned > staticPreds; // predicates that no action changes
+	VecMap ccs;                // nodes of each connected component of the network
+
+	std::vector< UnsignedVec > inEdges, outEdges; // indices of the edges entering/leaving each node
+
+	NetworkCompiler( const MultiagentDomain & dom, bool staticInlining = true, bool bounded = false, bool symmetry = false );
+
+	std::shared_ptr< pddl::Domain > compileDomain() const;
+
+	// types, constants and predicates of the classical domain without its
+	// actions; enough to compile instances when the domain is not printed
+	std::shared_ptr< pddl::Domain > compileSignature() const;
+
+	std::shared_ptr< pddl::Instance > compileInstance( pddl::Domain & cd, const pddl::Instance & ins ) const;
+
+	// largest value of the bounded counter of node x: its upper bound if it
+	// is finite, and otherwise its lower bound (more actions than that
+	// never change whether the node is satisfied)
+	unsigned counterBound( unsigned x ) const;
+
+private:
+	// name of the predicate of the bounded counter of node x with value k
+	std::string counter( unsigned x, unsigned k ) const;
+
+	bool deletes( const pddl::Ground & ground, const NetworkNode & n, unsigned k ) const;
+
+	// returns true if at least one instance of "POS-" or "NEG-" added
+	bool addEff( pddl::Domain & cd, pddl::Action & a, const std::shared_ptr< pddl::Condition > & c ) const;
+
+	// static facts that every action of node x needs, projected on the
+	// parameters of the node (nullptr if some action needs none)
+	std::shared_ptr< pddl::Condition > staticPrecondition( const pddl::Domain & cd, unsigned x ) const;
+};
+
+} } // namespaces
@@ -17,11 +17,9 @@ public:
 	NetworkNode(const std::string& s)
 		: pddl::ParamCond( s ), lower( 0 ), upper( 0 ) {}
 
+	// templates are never modified after parsing, so copies share them
 	NetworkNode(const NetworkNode& n, const Domain& d)
-		: pddl::ParamCond( n ), lower( n.lower ), upper( n.upper ) {
-		for (const auto& i : n.templates)
-			templates.emplace_back(std::dynamic_pointer_cast<pddl::ParamCond>(i->copy(d)));
-	}
+		: pddl::ParamCond( n ), lower( n.lower ), upper( n.upper ), templates( n.templates ) {}
 
 	~NetworkNode() override = default;
 
@@ -0,0 +1,58 @@
+
+#pragma once
+
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace parser { namespace multiagent {
+
+// number of worker threads to use when none is requested explicitly
+inline unsigned defaultThreads()
+{
+	unsigned n = std::thread::hardware_concurrency();
+	return n ? n : 1;
+}
+
+// Runs f( job, worker ) for every job in [0, jobs) on at most `threads`
+// threads. Jobs are handed out in increasing order to whichever worker is
+// free; worker is in [0, threads) so callers can keep per-worker state.
+// The first exception thrown by a job is rethrown once all workers stopped.
+inline void parallelFor( unsigned jobs, unsigned threads, const std::function< void( unsigned, unsigned ) > & f )
+{
+	if ( threads > jobs ) threads = jobs;
+	if ( threads <= 1 ) {
+		for ( unsigned i = 0; i < jobs; ++i ) f( i, 0 );
+		return;
+	}
+
+	std::atomic< unsigned > next( 0 );
+	std::exception_ptr error;
+	std::mutex errorMutex;
+
+	auto work = [&]( unsigned worker ) {
+		for ( unsigned i = next++; i < jobs; i = next++ ) {
+			try {
+				f( i, worker );
+			}
+			catch ( ... ) {
+				std::lock_guard< std::mutex > lock( errorMutex );
+				if ( !error ) error = std::current_exception();
+				next = jobs;
+			}
+		}
+	};
+
+	std::vector< std::thread > workers;
+	for ( unsigned w = 1; w < threads; ++w )
+		workers.emplace_back( work, w );
+	work( 0 );
+	for ( auto & w : workers ) w.join();
+
+	if ( error ) std::rethrow_exception( error );
+}
+
+} } // namespaces
@@ -0,0 +1,41 @@
+
+#pragma once
+
+#include <parser/Instance.h>
+
+namespace parser { namespace multiagent {
+
+// Projection of a multiagent task (with the agent as first parameter of every
+// action) onto each of its agents, as needed by distributed planners: the task
+// of an agent has only the actions it can do, restricted to it by a SELF
+// precondition, the predicates that these actions use and the facts of the
+// initial state and the goal on those predicates. A predicate whose actions
+// always take the agent at the same argument is private to the agents, so
+// each task only keeps its own facts of the predicate. Literals on actions
+// of other agents (concurrency constraints) are dropped from the
+// preconditions.
+//
+// Agents that can do the same actions share the same projected domain, which
+// in turn shares the types, predicates, functions and unchanged conditions
+// of the multiagent domain, so nothing is deep-copied. The multiagent domain
+// and instance must outlive the projection.
+class Projection
+{
+public:
+	struct AgentTask
+	{
+		std::string agent;
+		std::shared_ptr< pddl::Domain > domain;
+		std::shared_ptr< pddl::Instance > instance;
+	};
+
+	const pddl::Domain & d;
+
+	std::vector< int > agentArg; // argument of each predicate that is the agent, or -1 if the predicate is public
+	std::vector< AgentTask > tasks;
+
+	// the instances of the agents are created on the given number of threads
+	Projection( const pddl::Domain & dom, const pddl::Instance & ins, unsigned threads = 1 );
+};
+
+} } // namespaces
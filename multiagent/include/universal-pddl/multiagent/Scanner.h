@@ -0,0 +1,30 @@
+
+#pragma once
+
+#include <parser/Filereader.h>
+
+namespace parser { namespace multiagent {
+
+// Bulk scanning of the lines read by a Filereader. Problem files are mostly
+// blanks, parentheses and short names, so the characters of a line are
+// classified 32 (AVX2) or 16 (SSE2) at a time when the compiler targets those
+// instruction sets, and one at a time otherwise.
+
+// position of the first character of s at or after c that is not a space,
+// tab, carriage return or newline (s.size() if there is none)
+size_t skipBlank( const std::string & s, size_t c );
+
+// position of the first character of s at or after c that ends a name: a
+// blank, a parenthesis or the start of a comment (s.size() if there is none)
+size_t tokenEnd( const std::string & s, size_t c );
+
+// instruction set used by skipBlank and tokenEnd ("AVX2", "SSE2" or "scalar")
+const char * scannerInstructions();
+
+// same as f.next() and f.getToken() (which returns names in uppercase),
+// skipping blanks and finding the end of the token in bulk; f only reads a
+// new line when the current one ends
+void scanNext( pddl::Filereader & f );
+std::string scanToken( pddl::Filereader & f );
+
+} } // namespaces
@@ -0,0 +1,32 @@
+
+#pragma once
+
+#include <parser/Domain.h>
+
+namespace parser { namespace multiagent {
+
+// Compiled actions share the nodes of their conditions that the compilers do
+// not change with the actions of the source domain and with each other, so a
+// node that is part of a condition is never modified in place: rewrites copy
+// the path from the root to the nodes that change and keep the rest (copy on
+// write). The source domain must outlive the domains compiled from it.
+
+// c with the parameters greater than or equal to m shifted by n, as
+// Condition::addParams, sharing the subtrees that have no such parameter.
+// Other nodes (such as increases, and atoms of subclasses of Ground other
+// than Equals) are copied into d by their own class and shifted.
+std::shared_ptr< pddl::Condition > shiftParams( const pddl::Domain & d, const std::shared_ptr< pddl::Condition > & c, int m, unsigned n );
+
+// Appends parameters of the given types to action a of domain d, as
+// Action::addParams, without modifying the nodes of its conditions
+void appendParams( const pddl::Domain & d, pddl::Action & a, const IntVec & types );
+
+// new conjunction that shares the conjuncts of c (or c, if it is not a
+// conjunction), to which an action can add conditions of its own
+std::shared_ptr< pddl::And > shareConjuncts( const std::shared_ptr< pddl::Condition > & c );
+
+// Number of distinct nodes of the conditions of the actions of `to`, and how
+// many of them are also nodes of the actions of `from` (shared, not copied)
+std::pair< unsigned, unsigned > sharedNodes( const pddl::Domain & from, const pddl::Domain & to );
+
+} } // namespaces
@@ -0,0 +1,32 @@
+
+#pragma once
+
+#include <parser/Domain.h>
+
+namespace parser { namespace multiagent {
+
+// Simplification of the actions of a compiled classical domain. Nested
+// conjunctions are flattened, repeated literals are removed, a negative
+// effect is dropped if the same conjunction adds the atom again (adds win
+// over deletes), foralls and whens without effect or condition are removed
+// and actions whose precondition contains a literal and its negation are
+// deleted since they can never be applied.
+class Simplifier
+{
+public:
+	unsigned actionsBefore, actionsAfter; // number of actions
+	unsigned sizeBefore, sizeAfter;       // number of condition nodes of all actions
+
+	Simplifier()
+		: actionsBefore( 0 ), actionsAfter( 0 ), sizeBefore( 0 ), sizeAfter( 0 ) {}
+
+	void simplify( pddl::Domain & cd );
+
+	// number of nodes of a condition
+	static unsigned size( const std::shared_ptr< pddl::Condition > & c );
+
+	// prints the reduction of the domains simplified so far
+	void report( std::ostream & os ) const;
+};
+
+} } // namespaces
@@ -0,0 +1,19 @@
+
+#pragma once
+
+#include <parser/Domain.h>
+
+#include <multiagent/FrozenDomain.h>
+
+namespace parser { namespace multiagent {
+
+// Indices of the predicates of d that no action adds or deletes. Facts of
+// these predicates keep their initial value in every reachable state. The
+// second version reads a domain that was already frozen.
+std::set< unsigned > staticPredicates( const pddl::Domain & d );
+std::set< unsigned > staticPredicates( const FrozenDomain & d );
+
+// literals (Ground or Not) in the top-level conjunction of the precondition of a
+pddl::CondVec preconditionLiterals( const pddl::Action & a );
+
+} } // namespaces
@@ -0,0 +1,78 @@
+
+#pragma once
+
+#include <parser/Instance.h>
+
+#include <multiagent/ConcurrencyCompiler.h>
+#include <multiagent/FrozenDomain.h>
+#include <multiagent/NetworkCompiler.h>
+#include <multiagent/TypeHierarchy.h>
+
+namespace parser { namespace multiagent {
+
+// Size of the grounding of a schema (action, network node or compiled task):
+// "naive" is the product of the number of objects of the types of its
+// parameters, as counted by a grounder that only uses types, and "estimate"
+// also assumes that each positive static precondition keeps the fraction of
+// the parameter tuples that the initial state makes true.
+struct GroundingSize
+{
+	double naive = 0, estimate = 0;
+
+	GroundingSize & operator+=( const GroundingSize & s )
+	{
+		naive += s.naive;
+		estimate += s.estimate;
+		return *this;
+	}
+};
+
+// Statistics of a multiagent domain and an instance of it, computed from the
+// parsed files only (nothing is compiled or grounded), so they are cheap
+// enough to decide how to schedule the compilation of the instance. The
+// schemas are read from a frozen copy of the domain and the objects of each
+// type from its type hierarchy, both computed on construction. A lazy domain
+// whose conditions were not parsed only has the sizes by types.
+class DomainStatistics
+{
+public:
+	struct Schema
+	{
+		std::string name;
+		unsigned arity;
+		GroundingSize size;
+	};
+
+	const pddl::Domain & d;
+
+	std::vector< std::pair< std::string, unsigned > > objects; // number of objects of each type (with its subtypes)
+	std::vector< Schema > actions;
+	std::vector< Schema > nodes; // concurrency network nodes (empty unless d is a MultiagentDomain)
+	double groundPredicates;     // ground atoms of the predicates
+
+	DomainStatistics( const pddl::Domain & dom, const pddl::Instance & ins );
+
+	GroundingSize groundActions() const;
+
+	// ground actions of the tasks compiled from the instance by each compiler
+	// (the compiler must use the domain of the statistics)
+	GroundingSize compiledSize( const NetworkCompiler & compiler ) const;
+	GroundingSize compiledSize( const ConcurrencyCompiler & compiler ) const;
+
+	void report( std::ostream & os ) const;
+
+private:
+	std::shared_ptr< const FrozenDomain > fd;
+	TypeHierarchy hierarchy;
+	std::map< int, unsigned > facts; // initial facts of each static predicate
+
+	unsigned agents() const;
+
+	// size of the grounding of parameters of the given types
+	double typeProduct( std::span< const int > types ) const;
+
+	// size of the grounding of action a of fd
+	GroundingSize actionSize( int a ) const;
+};
+
+} } // namespaces
@@ -0,0 +1,28 @@
+
+#pragma once
+
+#include <parser/Instance.h>
+
+namespace parser { namespace multiagent {
+
+// Orbits of interchangeable agents of an instance: agents of the same type
+// such that exchanging them maps the initial state and the goal onto
+// themselves. Every permutation of the agents of an orbit is a symmetry of
+// the task (as long as the domain does not name agents as constants, which
+// are never placed in an orbit), so a planner only needs to consider plans
+// where the agents of an orbit start acting in a fixed order.
+class AgentSymmetry
+{
+public:
+	std::vector< StringVec > orbits; // orbits with at least two agents
+
+	AgentSymmetry( const pddl::Domain & d, const pddl::Instance & ins );
+
+	// number of permutations of the agents that are symmetries of the task
+	// (the product of the factorials of the sizes of the orbits)
+	double permutations() const;
+
+	void report( std::ostream & os ) const;
+};
+
+} } // namespaces
@@ -0,0 +1,76 @@
+
+#pragma once
+
+#include <span>
+
+#include <parser/Domain.h>
+
+namespace parser { namespace multiagent {
+
+// Transitive closure of the types of a domain, with the supertypes of each
+// type in a bitset so that subtype tests are one bit lookup, and the objects
+// and constants of all types in arrays ordered by a preorder walk of the
+// types: the objects of a type and of all its subtypes are contiguous.
+//
+// The hierarchy is computed when it is built and by update(). Compilers add
+// types (AGENT, AGENT-COUNT, ATOMIC-ACTION-COUNT, ...) and objects to their
+// domains and instances, so update() compares the domain with the hierarchy
+// and computes it again if some type was added or moved or the objects or
+// constants declared in some type changed. Objects and constants are
+// compared through a hash of their names, so an object that is renamed or
+// replaced by another one is noticed even if the counts stay the same.
+class TypeHierarchy
+{
+public:
+	explicit TypeHierarchy( const pddl::Domain & d );
+
+	// whether the hierarchy is that of the domain now
+	bool current() const;
+
+	// computes the hierarchy again if it is not current; returns whether it did
+	bool update();
+
+	unsigned types() const { return supertypes.size(); }
+
+	// whether type t is type u or one of its subtypes
+	bool subtype( unsigned t, unsigned u ) const
+	{
+		return closure[t * words + u / 64] >> ( u % 64 ) & 1;
+	}
+
+	// objects (constants) of type t and its subtypes
+	std::span< const std::string > objects( unsigned t ) const
+	{
+		return std::span< const std::string >( names.data() + objectRanges[t].first, objectRanges[t].second - objectRanges[t].first );
+	}
+	std::span< const std::string > constants( unsigned t ) const
+	{
+		return std::span< const std::string >( constantNames.data() + constantRanges[t].first, constantRanges[t].second - constantRanges[t].first );
+	}
+
+	// type in which object (constant) s is declared, or -1 if there is none
+	int objectType( const std::string & s ) const;
+	int constantType( const std::string & s ) const;
+
+	// whether s is an object or a constant of type t or one of its subtypes
+	bool isA( const std::string & s, unsigned t ) const;
+
+private:
+	const pddl::Domain & d;
+
+	// state of the domain when the hierarchy was computed
+	IntVec supertypes;
+	std::vector< size_t > fingerprints; // hash of the objects and constants declared in each type
+
+	unsigned words;                       // words of the bitset of each type
+	std::vector< unsigned long long > closure; // supertypes of each type (including itself)
+
+	StringVec names, constantNames;
+	std::vector< std::pair< unsigned, unsigned > > objectRanges, constantRanges; // [first, last) of each type
+	std::map< std::string, int > objectTypes, constantTypes;
+
+	void build();
+	void visit( unsigned t, const std::vector< UnsignedVec > & subtypes );
+};
+
+} } // namespaces
@@ -2,6 +2,7 @@
 #include <parser/Domain.h>
 
 #include <multiagent/AgentAction.h>
+#include <multiagent/Scanner.h>
 
 #include "ConcurrencyDomain.h"
 #include "MultiagentDomain.h"
@@ -40,6 +41,12 @@ void AgentAction::PDDLPrint( std::ostream & s, unsigned indent, const TokenStruc
 }
 
 void AgentAction::parse( Filereader & f, TokenStruct< std::string > & ts, pddl::Domain & d )
+{
+	TokenStruct<std::string> astruct = parseHeader( f, d );
+	parseConditions( f, astruct, d );
+}
+
+TokenStruct< std::string > AgentAction::parseHeader( Filereader & f, pddl::Domain & d )
 {
 	TokenStruct<std::string> astruct;
 
@@ -55,24 +62,23 @@ void AgentAction::parse( Filereader & f, TokenStruct< std::string > & ts, pddl::
 
 	if (!fact)
 	{
-		f.next();
+		scanNext( f );
 		f.assert_token(":AGENT");
-		astruct.insert(f.getToken());
+		astruct.insert(scanToken( f ));
 		if (d.typed) {
-			f.next();
+			scanNext( f );
 			f.assert_token("-");
 			astruct.types.push_back(f.getToken(d.types));
 		}
 		else astruct.types.emplace_back("OBJECT");
 	}
 
-	f.next();
+	scanNext( f );
 	f.assert_token( ":PARAMETERS" );
 	f.assert_token( "(" );
 	astruct.append( f.parseTypedList( true, d.types ) );
 	params = d.convertTypes( astruct.types );
-
-	parseConditions( f, astruct, d );
+	return astruct;
 }
 
 } } // namespaces
@@ -0,0 +1,1075 @@
+
+#include <multiagent/ConcurrencyCompiler.h>
+#include <multiagent/FactTable.h>
+#include <multiagent/Parallel.h>
+#include <multiagent/SharedConditions.h>
+#include <multiagent/StaticPredicates.h>
+#include <multiagent/TypeHierarchy.h>
+
+namespace parser { namespace multiagent {
+
+using namespace pddl;
+
+static void addTypes(const ConcurrencyDomain& d, Domain& cd, bool useAgentOrder, int maxJointActionSize )
+{
+	cd.setTypes(d.copyTypes());
+
+	if (useAgentOrder)
+		cd.createType("AGENT-ORDER-COUNT");
+
+	if (maxJointActionSize > 0)
+		cd.createType("ATOMIC-ACTION-COUNT");
+}
+
+static void addAgentType(ConcurrencyDomain& d)
+{
+	// in some domains, the AGENT type is not specified, so we add the type
+	// manually
+	// all the types in :agent have their supertype set to AGENT (if they do not
+	// already have it)
+	if ( d.types.index( "AGENT" ) < 0 ) 
+	{
+		// get types of agents (first parameter of actions)
+		std::set<std::shared_ptr<Type>> agentTypes;
+		for ( unsigned i = 0; i < d.actions.size(); ++i ) 
+		{
+			auto action = d.actions[i];
+			StringVec actionParams = d.typeList(*action);
+			if (!actionParams.empty()) 
+			{
+				const std::string& firstParamStr = actionParams[0];
+				auto firstParamType = d.getType( firstParamStr );
+				agentTypes.insert( firstParamType );
+			}
+		}
+
+		// get supertypes only (as subtypes are already covered by supertypes)
+		const TypeHierarchy & hierarchy = d.typeHierarchy();
+		std::set<std::shared_ptr<Type>> agentSupertypes;
+		for ( const auto& currentType : agentTypes )
+		{
+			unsigned t = d.types.index( currentType->name );
+			bool isSupertype = std::ranges::none_of( agentTypes, [&]( const std::shared_ptr<Type>& u )
+			{
+				return u != currentType && hierarchy.subtype( t, d.types.index( u->name ) );
+			} );
+			if (isSupertype)
+			{
+				agentSupertypes.insert(currentType);
+			}
+		}
+
+		// check if all supertypes share a common parent (it is necessary, since types
+		// can only have one parent)
+		bool allHaveSameParent = true;
+		auto parentType = (*(agentSupertypes.begin()))->supertype.lock();
+
+		for (const auto& agentSupertype : agentSupertypes)
+		{
+			if (agentSupertype->supertype.lock() != parentType) 
+			{
+				allHaveSameParent = false;
+				break;
+			}
+		}
+
+		// if all have same parent, add AGENT type between supertype and members
+		// of agentSupertypes
+		if ( allHaveSameParent ) 
+		{
+			d.createType("AGENT", parentType->name);
+			auto agentType = d.getType( "AGENT" );
+
+			for (const auto& agentSupertype : agentSupertypes)
+			{
+				for (auto it = parentType->subtypes.begin(); it != parentType->subtypes.end();)
+				{
+					if (it->lock() == agentSupertype)
+					{
+						parentType->subtypes.erase(it);
+						connect_types(agentType, agentSupertype);
+						//agentType->insertSubtype( agentSupertype );
+						break;
+					}
+					++it;
+				}
+			}
+		}
+	}
+}
+
+static void addFunctions(const ConcurrencyDomain& d, Domain& cd)
+{
+	for (const auto& f : d.funcs)
+		cd.createFunction(f->name, f->returnType, d.typeList(*f));
+}
+
+struct ConditionClassification
+{
+	unsigned numActionParams;
+	unsigned lastParamId;
+
+	std::map<unsigned, std::weak_ptr<Condition>> paramToCond; // parameter number to condition that declares it (forall, exists)
+
+	CondVec posConcConds; // conditions that include positive concurrency
+	CondVec negConcConds; // conditions that include negative concurrency
+	CondVec normalConds; // conditions that do not include concurrency constraints
+
+	CondVec checkedConds; // conditions that have been checked and cannot be checked again (i.e. exists)
+
+	std::set<std::tuple<bool, std::string, IntVec>, std::less<>> knownStatic; // static literals (negated, name, params) in the precondition of the action, looked up without copies
+
+	ConditionClassification( unsigned numParams)
+		: numActionParams( numParams ), lastParamId( numParams - 1 ) {
+	}
+
+	~ConditionClassification() = default;
+};
+
+static void addNoopAction( ConcurrencyDomain& d )
+{
+	std::string actionName = "NOOP";
+	auto a = std::make_shared<ConcurrentAction>(actionName);
+	a->params.emplace_back(d.types.index("AGENT"));
+	a->pre = std::make_shared<And>();
+	a->eff = std::make_shared<And>();
+	d.actions.insert(a);
+	d.addConcurrencyPredicateFromAction(*a);
+}
+
+static void addOriginalPredicates(const ConcurrencyDomain& d, Domain& cd)
+{
+	for (const auto& pred : d.preds)
+	{
+		if (d.cpreds.index(pred->name) == -1)
+		{
+			cd.createPredicate(pred->name, d.typeList(*pred));
+		}
+		else
+		{
+			cd.createPredicate("ACTIVE-" + pred->name, d.typeList(*pred));
+			cd.createPredicate("REQ-NEG-" + pred->name, d.typeList(*pred));
+		}
+	}
+}
+
+static void addStatePredicates(Domain& cd)
+{
+	cd.createPredicate( "FREE-BLOCK" );
+	cd.createPredicate( "SELECTING" );
+	cd.createPredicate( "APPLYING" );
+	cd.createPredicate( "RESETTING" );
+
+	cd.createPredicate( "FREE-AGENT", StringVec( 1, "AGENT" ) );
+	cd.createPredicate( "BUSY-AGENT", StringVec( 1, "AGENT" ) );
+	cd.createPredicate( "DONE-AGENT", StringVec( 1, "AGENT" ) );
+}
+
+static void addAgentOrderPredicates(Domain& cd)
+{
+	auto sv = StringVec( 1, "AGENT" );
+	sv.emplace_back("AGENT-ORDER-COUNT" );
+	cd.createPredicate( "AGENT-ORDER", sv );
+
+	cd.createPredicate( "PREV-AGENT-ORDER-COUNT", StringVec( 2, "AGENT-ORDER-COUNT" ) );
+	cd.createPredicate( "NEXT-AGENT-ORDER-COUNT", StringVec( 2, "AGENT-ORDER-COUNT" ) );
+	cd.createPredicate( "CURRENT-AGENT-ORDER-COUNT", StringVec( 1, "AGENT-ORDER-COUNT" ) );
+}
+
+static void addJointActionSizePredicates(Domain& cd, int maxJointActionSize)
+{
+	cd.createPredicate( "PREV-ATOMIC-ACTION-COUNT", StringVec( 2, "ATOMIC-ACTION-COUNT" ) );
+	cd.createPredicate( "NEXT-ATOMIC-ACTION-COUNT", StringVec( 2, "ATOMIC-ACTION-COUNT" ) );
+	cd.createPredicate( "CURRENT-ATOMIC-ACTION-COUNT", StringVec( 1, "ATOMIC-ACTION-COUNT" ) );
+}
+
+static void addPredicates(const ConcurrencyDomain& d, Domain& cd, bool useAgentOrder, int maxJointActionSize)
+{
+	addStatePredicates( cd );
+	addOriginalPredicates( d, cd );
+
+	if ( useAgentOrder ) {
+		addAgentOrderPredicates( cd );
+	}
+
+	if ( maxJointActionSize > 0 ) {
+		addJointActionSizePredicates( cd, maxJointActionSize );
+	}
+}
+
+// Returns cond with the concurrency predicates renamed with the prefix (and
+// negated if turnNegative is set). cond is not modified: nodes that do not
+// change are shared with it and only the paths to renamed atoms are copied.
+static std::shared_ptr<Condition> replaceConcurrencyPredicates(const ConcurrencyDomain& d, Domain& cd, const std::shared_ptr<Condition>& cond, std::string& replacementPrefix, bool turnNegative )
+{
+	auto a = std::dynamic_pointer_cast<And>(cond);
+	if (a) 
+	{
+		CondVec conds;
+		for (const auto& c : a->conds)
+			conds.push_back( replaceConcurrencyPredicates( d, cd, c, replacementPrefix, turnNegative ) );
+		if ( conds == a->conds )
+			return a;
+		auto na = std::make_shared<And>();
+		na->conds = conds;
+		return na;
+	}
+
+	auto e = std::dynamic_pointer_cast<Exists>( cond );
+	if ( e ) {
+		auto body = replaceConcurrencyPredicates( d, cd, e->cond, replacementPrefix, turnNegative );
+		if ( body == e->cond )
+			return e;
+		auto ne = std::make_shared<Exists>();
+		ne->name = e->name;
+		ne->params = e->params;
+		ne->cond = body;
+		return ne;
+	}
+
+	auto f = std::dynamic_pointer_cast<Forall>( cond );
+	if ( f ) {
+		auto body = replaceConcurrencyPredicates( d, cd, f->cond, replacementPrefix, turnNegative );
+		if ( body == f->cond )
+			return f;
+		auto nf = std::make_shared<Forall>();
+		nf->name = f->name;
+		nf->params = f->params;
+		nf->cond = body;
+		return nf;
+	}
+
+	auto i = std::dynamic_pointer_cast<Increase>( cond );
+	if ( i ) {
+		return i;
+	}
+
+	auto n = std::dynamic_pointer_cast<Not>( cond );
+	if ( n ) {
+		auto ng = std::dynamic_pointer_cast<Ground>( replaceConcurrencyPredicates( d, cd, n->cond, replacementPrefix, turnNegative ) );
+		if ( ng == n->cond )
+			return n;
+		return std::make_shared<Not>( ng );
+	}
+
+	auto g = std::dynamic_pointer_cast<Ground>( cond );
+	if ( g ) 
+	{
+		if ( d.cpreds.index( g->name ) != -1 ) 
+		{
+			auto ng = std::make_shared<Ground>( cd.preds.get( replacementPrefix + g->name ), g->params );
+			if ( turnNegative ) {
+				return std::make_shared<Not>(ng);
+			}
+			return ng;
+		}
+		return g;
+	}
+
+	auto o = std::dynamic_pointer_cast<Or>( cond );
+	if ( o ) {
+		auto first = replaceConcurrencyPredicates( d, cd, o->first, replacementPrefix, turnNegative );
+		auto second = replaceConcurrencyPredicates( d, cd, o->second, replacementPrefix, turnNegative );
+		if ( first == o->first && second == o->second )
+			return o;
+		auto no = std::make_shared<Or>();
+		no->first = first;
+		no->second = second;
+		return no;
+	}
+
+	auto w = std::dynamic_pointer_cast<When>( cond );
+	if ( w ) {
+		auto pars = replaceConcurrencyPredicates( d, cd, w->pars, replacementPrefix, turnNegative );
+		auto body = replaceConcurrencyPredicates( d, cd, w->cond, replacementPrefix, turnNegative );
+		if ( pars == w->pars && body == w->cond )
+			return w;
+		auto nw = std::make_shared<When>();
+		nw->pars = pars;
+		nw->cond = body;
+		return nw;
+	}
+
+	return nullptr;
+}
+
+static int getDominantGroundTypeForCondition(const ConcurrencyDomain& d, const std::shared_ptr<Condition>& cond)
+{
+	auto a = std::dynamic_pointer_cast<And>( cond );
+	if ( a ) 
+	{
+		int finalRes = 0;
+		for (const auto& cond : a->conds)
+		{
+			finalRes = getDominantGroundTypeForCondition( d, cond);
+			if ( finalRes == -1 || finalRes == 1 ) {
+				break;
+			}
+		}
+		return finalRes;
+	}
+
+	auto e = std::dynamic_pointer_cast<Exists>( cond );
+	if ( e ) {
+		return getDominantGroundTypeForCondition( d, e->cond );
+	}
+
+	auto f = std::dynamic_pointer_cast<Forall>( cond );
+	if ( f ) {
+		return getDominantGroundTypeForCondition( d, f->cond );
+	}
+
+	auto n = std::dynamic_pointer_cast<Not>( cond );
+	if ( n ) {
+		auto gn = std::dynamic_pointer_cast<Ground>( n->cond );
+
+		if ( d.cpreds.index( gn->name ) != -1 ) {
+			return -1;
+		}
+		else {
+			return -2;
+		}
+	}
+
+	auto g = std::dynamic_pointer_cast<Ground>( cond );
+	if ( g ) 
+	{
+		if ( d.cpreds.index( g->name ) != -1 ) {
+			return 1;
+		}
+		else {
+			return 2;
+		}
+	}
+
+	return 0;
+}
+
+static std::pair<std::shared_ptr<Condition>, int> createFullNestedCondition(const ConcurrencyDomain& d, const Domain& cd, const std::shared_ptr<Ground>& g, int groundType, ConditionClassification& condClassif, const CondVec& nestedConditions )
+{
+	std::shared_ptr<Condition> finalCond;
+	int finalGroundType = groundType;
+	std::shared_ptr<And> lastAnd = nullptr;
+
+	for (const auto& nestedCondition : nestedConditions)
+	{
+		std::shared_ptr<Condition> newCond;
+		std::shared_ptr<And> currentAnd;
+
+		auto f = std::dynamic_pointer_cast<Forall>(nestedCondition);
+		if ( f ) 
+		{
+			auto nf = std::make_shared<Forall>();
+			nf->params = IntVec( f->params );
+			nf->cond = std::make_shared<And>();
+
+			newCond = nf;
+			currentAnd = std::dynamic_pointer_cast<And>( nf->cond );
+		}
+
+		auto e = std::dynamic_pointer_cast<Exists>(nestedCondition);
+		if ( e ) 
+		{
+			std::shared_ptr<Exists> ne;
+
+			if (std::dynamic_pointer_cast<And>( e->cond ) ) 
+			{
+				ne = e;
+			}
+			else {
+				ne = std::make_shared<Exists>();
+				ne->params = IntVec( e->params );
+
+				auto newAnd = std::make_shared<And>();
+				newAnd->add( e->cond );
+
+				ne->cond = newAnd;
+			}
+
+			condClassif.checkedConds.emplace_back(nestedCondition);
+
+			// the ground type can be changed if there is a concurrency predicate
+			// inside the exists
+			if ( groundType != -1 && groundType != 1 ) 
+			{
+				finalGroundType = getDominantGroundTypeForCondition(d, nestedCondition);
+			}
+
+			newCond = ne;
+			currentAnd = nullptr; // do not nest anything more inside this structure
+		}
+
+		if ( newCond ) {
+			if ( !finalCond ) {
+				finalCond = newCond;
+			}
+
+			if ( lastAnd ) {
+				lastAnd->add( newCond );
+			}
+
+			lastAnd = currentAnd;
+
+			if ( !lastAnd ) {
+				break;
+			}
+		}
+	}
+
+	if ( lastAnd ) { // just non null in the case of forall
+		switch ( finalGroundType ) {
+			case -2:
+			{
+				auto cg = std::dynamic_pointer_cast<Ground>(g->copy(cd));
+				lastAnd->add(std::make_shared<Not>(cg));
+				break;
+			}
+			case -1:
+			case 1:
+				lastAnd->add(g);
+				break;
+			case 2:
+				lastAnd->add(g->copy(cd));
+				break;
+		}
+	}
+
+	return std::make_pair( finalCond, finalGroundType );
+}
+
+static bool isGroundClassified(const Ground& g, const ConditionClassification& condClassif)
+{
+	for (int paramId : g.params)
+	{
+		if (paramId < 0)
+			continue;
+
+		if ( paramId >= condClassif.numActionParams ) { // non-action parameter (introduced by forall or exists)
+			auto cond = condClassif.paramToCond.at(paramId).lock();
+			if (std::ranges::find(condClassif.checkedConds, cond) != condClassif.checkedConds.end() ) 
+				return true;
+		}
+	}
+
+	return false;
+}
+
+static void getNestedConditionsForGround(CondVec& nestedConditions, const Ground& g, const ConditionClassification& condClassif )
+{
+	std::shared_ptr<Condition> lastNestedCondition;
+
+	std::set< int > sortedGroundParams( g.params.begin(), g.params.end() ); // sort to respect nested order
+
+	for (int paramId : sortedGroundParams)
+	{
+		if (paramId < 0)
+			continue;
+
+		if ( paramId >= condClassif.numActionParams ) { // non-action parameter (introduced by forall or exists)
+			auto cond = condClassif.paramToCond.at(paramId).lock();
+			if ( cond != lastNestedCondition ) {
+				nestedConditions.emplace_back( cond );
+				lastNestedCondition = cond;
+			}
+		}
+	}
+}
+
+static void classifyGround(const ConcurrencyDomain& d, const Domain& cd, const std::shared_ptr<Ground>& g, int groundType, ConditionClassification & condClassif )
+{
+	if ( !isGroundClassified( *g, condClassif ) ) {
+		CondVec nestedConditions;
+		getNestedConditionsForGround( nestedConditions, *g, condClassif );
+
+		if (nestedConditions.empty()) 
+		{
+			switch ( groundType )
+			{
+				case -2:
+				{
+					auto cg = std::dynamic_pointer_cast<Ground>(g->copy(cd));
+					condClassif.normalConds.emplace_back(std::make_shared<Not>(cg));
+					break;
+				}
+				case -1:
+					condClassif.negConcConds.emplace_back(g);
+					break;
+				case 1:
+					condClassif.posConcConds.emplace_back(g);
+					break;
+				case 2:
+					condClassif.normalConds.emplace_back(g->copy(cd));
+					break;
+			}
+		}
+		else {
+			auto result = createFullNestedCondition( d, cd, g, groundType, condClassif, nestedConditions );
+			auto nestedCondition = result.first;
+			groundType = result.second;
+
+			switch ( groundType ) {
+				case -2:
+				case 2:
+					condClassif.normalConds.emplace_back( nestedCondition );
+					break;
+				case -1:
+					condClassif.negConcConds.emplace_back( nestedCondition );
+					break;
+				case 1:
+					condClassif.posConcConds.emplace_back( nestedCondition );
+					break;
+			}
+		}
+	}
+}
+
+static void getClassifiedConditions(const ConcurrencyDomain& d, const Domain& cd, const std::shared_ptr<Condition>& cond, ConditionClassification& condClassif)
+{
+	auto a = std::dynamic_pointer_cast<And>( cond );
+	for ( unsigned i = 0; a && i < a->conds.size(); ++i ) 
+	{
+		getClassifiedConditions( d, cd, a->conds[i], condClassif );
+	}
+
+	auto e = std::dynamic_pointer_cast<Exists>( cond );
+	if ( e ) {
+		for ( unsigned i = 0; i < e->params.size(); ++i ) {
+			++condClassif.lastParamId;
+			condClassif.paramToCond[ condClassif.lastParamId ] = e;
+		}
+
+		getClassifiedConditions( d, cd, e->cond, condClassif );
+
+		condClassif.lastParamId -= e->params.size();
+	}
+
+	auto f = std::dynamic_pointer_cast<Forall>( cond );
+	if ( f ) {
+		for ( unsigned i = 0; i < f->params.size(); ++i ) {
+			++condClassif.lastParamId;
+			condClassif.paramToCond[ condClassif.lastParamId ] = f;
+		}
+
+		getClassifiedConditions( d, cd, f->cond, condClassif );
+
+		condClassif.lastParamId -= f->params.size();
+	}
+
+	auto g = std::dynamic_pointer_cast<Ground>( cond );
+	if ( g ) {
+		int category = d.cpreds.index( g->name ) != -1 ? 1 : 2;
+		classifyGround( d, cd, g, category, condClassif );
+	}
+
+	auto n = std::dynamic_pointer_cast<Not>( cond );
+	if ( n ) {
+		auto ng = std::dynamic_pointer_cast<Ground>( n->cond );
+		if ( ng ) {
+			int category = d.cpreds.index( ng->name ) != -1 ? -1 : -2;
+			classifyGround( d, cd, ng, category, condClassif );
+		}
+		else {
+			getClassifiedConditions( d, cd, n->cond, condClassif );
+		}
+	}
+}
+
+// Removes from a concurrency condition the static literals that the top-level
+// precondition of the original action already requires. SELECT- checks them
+// and DO- and END- can only follow SELECT- with the same parameters, so they
+// are still true wherever the result is evaluated. cond is not modified; the
+// result shares the subtrees that have no such literal.
+static std::shared_ptr<Condition> removeKnownStatic(const std::shared_ptr<Condition>& cond, const ConditionClassification& condClassif)
+{
+	if ( condClassif.knownStatic.empty() )
+		return cond;
+
+	if ( auto a = std::dynamic_pointer_cast<And>( cond ) )
+	{
+		CondVec conds;
+		for (const auto& c : a->conds)
+		{
+			auto g = std::dynamic_pointer_cast<Ground>( c );
+			auto n = std::dynamic_pointer_cast<Not>( c );
+			if ( g && condClassif.knownStatic.contains( std::forward_as_tuple( false, g->name, g->params ) ) )
+				continue;
+			if ( n && n->cond && condClassif.knownStatic.contains( std::forward_as_tuple( true, n->cond->name, n->cond->params ) ) )
+				continue;
+			conds.push_back( removeKnownStatic( c, condClassif ) );
+		}
+		if ( conds == a->conds )
+			return a;
+		auto na = std::make_shared<And>();
+		na->conds = conds;
+		return na;
+	}
+	else if ( auto e = std::dynamic_pointer_cast<Exists>( cond ) )
+	{
+		auto body = removeKnownStatic( e->cond, condClassif );
+		if ( body == e->cond )
+			return e;
+		auto ne = std::make_shared<Exists>();
+		ne->name = e->name;
+		ne->params = e->params;
+		ne->cond = body;
+		return ne;
+	}
+	else if ( auto f = std::dynamic_pointer_cast<Forall>( cond ) )
+	{
+		auto body = removeKnownStatic( f->cond, condClassif );
+		if ( body == f->cond )
+			return f;
+		auto nf = std::make_shared<Forall>();
+		nf->name = f->name;
+		nf->params = f->params;
+		nf->cond = body;
+		return nf;
+	}
+	else if ( auto o = std::dynamic_pointer_cast<Or>( cond ) )
+	{
+		auto first = removeKnownStatic( o->first, condClassif );
+		auto second = removeKnownStatic( o->second, condClassif );
+		if ( first == o->first && second == o->second )
+			return o;
+		auto no = std::make_shared<Or>();
+		no->first = first;
+		no->second = second;
+		return no;
+	}
+
+	return cond;
+}
+
+static void addSelectAction(const ConcurrencyDomain& d, Domain& cd, int actionId, bool useAgentOrder, int maxJointActionSize, const ConditionClassification& condClassif)
+{
+	auto originalAction = d.actions[actionId];
+
+	std::string actionName = "SELECT-" + originalAction->name;
+
+	auto newAction = cd.createAction( actionName, d.typeList( *originalAction ) );
+	size_t numActionParams = newAction->params.size();
+
+	// preconditions
+	cd.addPre( false, actionName, "SELECTING" );
+	cd.addPre( false, actionName, "FREE-AGENT", IntVec( 1, 0 ) );
+	cd.addPre( true, actionName, "REQ-NEG-" + originalAction->name, incvec( 0, numActionParams ) );
+
+	auto actionPre = std::dynamic_pointer_cast<And>( newAction->pre );
+	std::string replacementPrefix = "ACTIVE-";
+
+	for (const auto& normalCond : condClassif.normalConds)
+		actionPre->add(normalCond);
+
+	for (const auto& negConcCond : condClassif.negConcConds)
+	{
+		auto replacedCondition = replaceConcurrencyPredicates( d, cd, removeKnownStatic( negConcCond, condClassif ), replacementPrefix, true );
+		actionPre->add( replacedCondition );
+	}
+
+	// effects
+	cd.addEff( true, actionName, "FREE-AGENT", IntVec( 1, 0 ) );
+	cd.addEff( false, actionName, "BUSY-AGENT", IntVec( 1, 0 ) );
+	cd.addEff( false, actionName, "ACTIVE-" + originalAction->name, incvec( 0, numActionParams ) );
+
+	auto actionEff = std::dynamic_pointer_cast<And>( newAction->eff );
+	replacementPrefix = "REQ-NEG-";
+
+	for (const auto& negConcCond : condClassif.negConcConds)
+	{
+		auto replacedCondition = replaceConcurrencyPredicates( d, cd, negConcCond, replacementPrefix, false );
+		actionEff->add( replacedCondition );
+	}
+
+	if ( useAgentOrder ) {
+		appendParams( cd, *newAction, cd.convertTypes( StringVec( 2, "AGENT-ORDER-COUNT" ) ) );
+
+		IntVec orderParams = IntVec( 1, 0 ); // agent parameter
+		orderParams.push_back( numActionParams ); // num of parameter corresponding to AGENT-ORDER-COUNT (just added in previous line)
+		cd.addPre( false, actionName, "AGENT-ORDER", orderParams );
+		cd.addPre( false, actionName, "NEXT-AGENT-ORDER-COUNT", incvec( numActionParams, numActionParams + 2 ) );
+		cd.addPre( false, actionName, "CURRENT-AGENT-ORDER-COUNT", IntVec( 1, static_cast<int>(numActionParams) ));
+
+		cd.addEff( true, actionName, "CURRENT-AGENT-ORDER-COUNT", IntVec( 1, static_cast<int>(numActionParams)) );
+		cd.addEff( false, actionName, "CURRENT-AGENT-ORDER-COUNT", IntVec( 1, static_cast<int>(numActionParams) + 1 ) );
+
+		numActionParams += 2;
+	}
+
+	if ( maxJointActionSize > 0 ) 
+	{
+		appendParams( cd, *newAction, cd.convertTypes( StringVec( 2, "ATOMIC-ACTION-COUNT" ) ) );
+
+		cd.addPre( false, actionName, "NEXT-ATOMIC-ACTION-COUNT", incvec( numActionParams, numActionParams + 2 ) );
+		cd.addPre( false, actionName, "CURRENT-ATOMIC-ACTION-COUNT", IntVec( 1, static_cast<int>(numActionParams)) );
+
+		cd.addEff( true, actionName, "CURRENT-ATOMIC-ACTION-COUNT", IntVec( 1, static_cast<int>(numActionParams)) );
+		cd.addEff( false, actionName, "CURRENT-ATOMIC-ACTION-COUNT", IntVec( 1, static_cast<int>(numActionParams) + 1 ) );
+	}
+}
+
+static void addDoAction(const ConcurrencyDomain& d, Domain& cd, int actionId, ConditionClassification & condClassif )
+{
+	auto originalAction = d.actions[actionId];
+
+	std::string actionName = "DO-" + originalAction->name;
+
+	auto newAction = cd.createAction( actionName, d.typeList( *originalAction ) );
+	size_t numActionParams = newAction->params.size();
+
+	// preconditions
+	cd.addPre( false, actionName, "APPLYING" );
+	cd.addPre( false, actionName, "BUSY-AGENT", IntVec( 1, 0 ) );
+	cd.addPre( false, actionName, "ACTIVE-" + originalAction->name, incvec( 0, numActionParams ) );
+
+	auto newActionPre = std::dynamic_pointer_cast<And>( newAction->pre );
+	std::string replacementPrefix = "ACTIVE-";
+
+	for (const auto& posConcCond : condClassif.posConcConds)
+	{
+		auto replacedCondition = replaceConcurrencyPredicates( d, cd, removeKnownStatic( posConcCond, condClassif ), replacementPrefix, false );
+		newActionPre->add( replacedCondition );
+	}
+
+	// effects
+	cd.addEff( true, actionName, "BUSY-AGENT", IntVec( 1, 0 ) );
+	cd.addEff( false, actionName, "DONE-AGENT", IntVec( 1, 0 ) );
+
+	auto newActionEff = std::dynamic_pointer_cast<And>( newAction->eff );
+
+	if (auto originalActionEff = std::dynamic_pointer_cast<And>( originalAction->eff ) ) 
+	{
+		for ( unsigned i = 0; i < originalActionEff->conds.size(); ++i ) 
+		{
+			newActionEff->add( originalActionEff->conds[i] );
+		}
+	}
+	else if ( originalAction->eff != nullptr )
+	{
+		newActionEff->add( originalAction->eff );
+	}
+
+	newAction->eff = replaceConcurrencyPredicates( d, cd, newAction->eff, replacementPrefix, false );
+}
+
+static void addEndAction(const ConcurrencyDomain& d, Domain& cd, int actionId, bool useAgentOrder, int maxJointActionSize, const ConditionClassification& condClassif )
+{
+	auto originalAction = d.actions[actionId];
+
+	std::string actionName = "END-" + originalAction->name;
+
+	auto newAction = cd.createAction( actionName, d.typeList( *originalAction ) );
+	unsigned numActionParams = newAction->params.size();
+
+	// preconditions
+	cd.addPre( false, actionName, "RESETTING" );
+	cd.addPre( false, actionName, "DONE-AGENT", IntVec( 1, 0 ) );
+	cd.addPre( false, actionName, "ACTIVE-" + originalAction->name, incvec( 0, numActionParams ) );
+
+	// effects
+	cd.addEff( true, actionName, "DONE-AGENT", IntVec( 1, 0 ) );
+	cd.addEff( false, actionName, "FREE-AGENT", IntVec( 1, 0 ) );
+	cd.addEff( true, actionName, "ACTIVE-" + originalAction->name, incvec( 0, numActionParams ) );
+
+	auto actionEff = std::dynamic_pointer_cast<And>( newAction->eff );
+	std::string replacementPrefix = "REQ-NEG-";
+
+	for (const auto& negConcCond : condClassif.negConcConds)
+	{
+		auto replacedCondition = replaceConcurrencyPredicates( d, cd, negConcCond, replacementPrefix, true );
+		actionEff->add( replacedCondition );
+	}
+
+	if ( useAgentOrder ) 
+	{
+		appendParams( cd, *newAction, cd.convertTypes( StringVec( 2, "AGENT-ORDER-COUNT" ) ) );
+
+		cd.addPre( false, actionName, "PREV-AGENT-ORDER-COUNT", incvec( numActionParams, numActionParams + 2 ) );
+		cd.addPre( false, actionName, "CURRENT-AGENT-ORDER-COUNT", IntVec( 1, static_cast<int>(numActionParams)) );
+
+		cd.addEff( true, actionName, "CURRENT-AGENT-ORDER-COUNT", IntVec( 1, static_cast<int>(numActionParams) ) );
+		cd.addEff( false, actionName, "CURRENT-AGENT-ORDER-COUNT", IntVec( 1, static_cast<int>(numActionParams) + 1 ) );
+
+		numActionParams += 2;
+	}
+
+	if ( maxJointActionSize > 0 ) 
+	{
+		appendParams( cd, *newAction, cd.convertTypes( StringVec( 2, "ATOMIC-ACTION-COUNT" ) ) );
+
+		cd.addPre( false, actionName, "PREV-ATOMIC-ACTION-COUNT", incvec( numActionParams, numActionParams + 2 ) );
+		cd.addPre( false, actionName, "CURRENT-ATOMIC-ACTION-COUNT", IntVec( 1, static_cast<int>(numActionParams)) );
+
+		cd.addEff( true, actionName, "CURRENT-ATOMIC-ACTION-COUNT", IntVec( 1, static_cast<int>(numActionParams)) );
+		cd.addEff( false, actionName, "CURRENT-ATOMIC-ACTION-COUNT", IntVec( 1, static_cast<int>(numActionParams) + 1 ) );
+	}
+}
+
+static void addStartAction(Domain& cd)
+{
+	std::string actionName = "START";
+	cd.createAction(actionName);
+	cd.addPre( false, actionName, "FREE-BLOCK" );
+	cd.addEff( true, actionName, "FREE-BLOCK" );
+	cd.addEff( false, actionName, "SELECTING" );
+}
+
+static void addApplyAction(Domain& cd)
+{
+	std::string actionName = "APPLY";
+	cd.createAction(actionName);
+	cd.addPre( false, actionName, "SELECTING" );
+	cd.addEff( true, actionName, "SELECTING" );
+	cd.addEff( false, actionName, "APPLYING" );
+}
+
+static void addResetAction(Domain& cd)
+{
+	std::string actionName = "RESET";
+	cd.createAction(actionName);
+	cd.addPre( false, actionName, "APPLYING" );
+	cd.addEff( true, actionName, "APPLYING" );
+	cd.addEff( false, actionName, "RESETTING" );
+}
+
+static void addFinishAction(Domain& cd)
+{
+	std::string actionName = "FINISH";
+	auto action = cd.createAction(actionName);
+	cd.addPre( false, actionName, "RESETTING" );
+	cd.addEff( true, actionName, "RESETTING" );
+	cd.addEff( false, actionName, "FREE-BLOCK" );
+
+	auto f = std::make_shared<Forall>();
+	f->params = cd.convertTypes( StringVec( 1, "AGENT" ) );
+	f->cond = std::make_shared<Ground>( cd.preds.get( "FREE-AGENT" ), incvec( 0, f->params.size() ) );
+
+	auto a = std::dynamic_pointer_cast<And>( action->pre );
+	a->add(f);
+}
+
+static void addStateChangeActions( Domain& cd )
+{
+	addStartAction( cd );
+	addApplyAction( cd );
+	addResetAction( cd );
+	addFinishAction( cd );
+}
+
+// private domain of a worker thread that shares the types, predicates and
+// functions of cd, so that actions can be created without touching cd
+static std::unique_ptr<Domain> createActionBuilder(const Domain& cd)
+{
+	auto b = std::make_unique<Domain>();
+	b->name = cd.name;
+	b->types = cd.types;
+	b->preds = cd.preds;
+	b->funcs = cd.funcs;
+	return b;
+}
+
+// static literals over parameters of the action in the top-level precondition of a
+static std::set<std::tuple<bool, std::string, IntVec>, std::less<>> knownStaticLiterals(const ConcurrencyDomain& d, const Action& a, const std::set<unsigned>& staticPreds)
+{
+	std::set<std::tuple<bool, std::string, IntVec>, std::less<>> known;
+	for (const auto& l : preconditionLiterals( a ))
+	{
+		auto n = std::dynamic_pointer_cast<Not>( l );
+		auto g = n ? n->cond : std::dynamic_pointer_cast<Ground>( l );
+		int pred = g ? d.preds.index( g->name ) : -1;
+		if ( pred < 0 || !staticPreds.contains( pred ) || d.cpreds.index( g->name ) != -1 )
+			continue;
+		if ( std::ranges::all_of( g->params, [&a]( int p ) { return p < static_cast<int>( a.params.size() ); } ) )
+			known.emplace( n != nullptr, g->name, g->params );
+	}
+	return known;
+}
+
+static void addActions(const ConcurrencyDomain& d, Domain& cd, bool useAgentOrder, int maxJointActionSize, bool inlineStatic, unsigned threads )
+{
+	addStateChangeActions( cd );
+
+	std::set<unsigned> staticPreds;
+	if ( inlineStatic )
+		staticPreds = staticPredicates( d );
+
+	// select, do and end actions for each original action. The original
+	// actions are compiled independently by the workers and the new actions
+	// are added to cd in the original order, so the output does not depend on
+	// the number of threads
+	std::vector<std::unique_ptr<Domain>> builders( std::max( threads, 1u ) );
+	std::vector<std::vector<std::shared_ptr<Action>>> created( d.actions.size() );
+
+	parallelFor( d.actions.size(), threads, [&]( unsigned i, unsigned w )
+	{
+		if ( !builders[w] )
+			builders[w] = createActionBuilder( cd );
+		Domain& b = *builders[w];
+		unsigned first = b.actions.size();
+
+		ConditionClassification condClassif( d.actions[i]->params.size() );
+		getClassifiedConditions( d, b, d.actions[i]->pre, condClassif );
+		if ( inlineStatic )
+			condClassif.knownStatic = knownStaticLiterals( d, *d.actions[i], staticPreds );
+
+		addSelectAction( d, b, i, useAgentOrder, maxJointActionSize, condClassif );
+		addDoAction( d, b, i, condClassif );
+		addEndAction( d, b, i, useAgentOrder, maxJointActionSize, condClassif );
+
+		for ( unsigned j = first; j < b.actions.size(); ++j )
+			created[i].push_back( b.actions[j] );
+	} );
+
+	for (const auto& actions : created)
+		for (const auto& a : actions)
+			cd.actions.insert( a );
+}
+
+static std::shared_ptr<Domain> createClassicalSignature(const ConcurrencyDomain& d, bool useAgentOrder, int maxJointActionSize )
+{
+	auto cd = std::make_shared<Domain>();
+	cd->name = d.name;
+	cd->condeffects = cd->cons = cd->typed = cd->neg = cd->equality = cd->universal = true;
+	cd->costs = d.costs;
+
+	addTypes(d, *cd, useAgentOrder, maxJointActionSize );
+	addFunctions( d, *cd);
+	addPredicates( d, *cd, useAgentOrder, maxJointActionSize );
+
+	return cd;
+}
+
+static std::shared_ptr<Domain> createClassicalDomain(const ConcurrencyDomain& d, bool useAgentOrder, int maxJointActionSize, bool inlineStatic, unsigned threads )
+{
+	auto cd = createClassicalSignature( d, useAgentOrder, maxJointActionSize );
+	addActions( d, *cd, useAgentOrder, maxJointActionSize, inlineStatic, threads );
+
+	return cd;
+}
+
+static std::shared_ptr<Instance> createTransformedInstance(Domain& cd, const Instance& ins, bool useAgentOrder, int maxJointActionSize )
+{
+	auto cins = std::make_shared<Instance>(cd);
+	cins->name = ins.name;
+	cins->metric = ins.metric;
+
+	// create initial state
+	auto agentType = cd.types.get( "AGENT" );
+	cins->addInit( "FREE-BLOCK" );
+	for ( unsigned i = 0; i < agentType->noObjects(); ++i ) {
+		cins->addInit( "FREE-AGENT", StringVec( 1, agentType->object(i).first ) );
+	}
+
+	FactCopier facts( ins.d, cd );
+	for (const auto& i : ins.init)
+	{
+		if ( cd.preds.index(i->name ) >= 0 ) 
+		{
+			if ( !facts.copyInit( *i, *cins ) )
+				cins->addInit(i->name, cd.objectList( *i) );
+		}
+		else if (auto gfd = std::dynamic_pointer_cast<GroundFunc<double>>(i) ) 
+		{
+			cins->addInit( gfd->name, gfd->value, cd.objectList( *gfd ) );
+		}
+		else if (auto gfi = std::dynamic_pointer_cast<GroundFunc<int>>(i) ) 
+		{
+			cins->addInit( gfi->name, gfi->value, cd.objectList( *gfi ) );
+		}
+	}
+
+	// create goal state
+	cins->addGoal( "FREE-BLOCK" );
+	for (const auto& i : ins.goal)
+		if ( !facts.copyGoal( *i, *cins ) )
+			cins->addGoal(i->name, cd.objectList( *i) );
+
+	if ( useAgentOrder ) 
+	{
+		for ( unsigned i = 1; i <= agentType->noObjects() + 1; ++i ) 
+		{
+			std::stringstream ss;
+			ss << "AGENT-COUNT" << i;
+			cins->addObject( ss.str(), "AGENT-ORDER-COUNT" );
+		}
+
+		if ( agentType->noObjects() > 0 ) 
+		{
+			cins->addInit( "CURRENT-AGENT-ORDER-COUNT", StringVec( 1, "AGENT-COUNT1" ) );
+		}
+
+		for ( unsigned i = 1; i <= agentType->noObjects(); ++i ) {
+			std::stringstream ss;
+			ss << "AGENT-COUNT" << i;
+
+			StringVec sv( 1, agentType->object(i - 1).first );
+			sv.push_back( ss.str() );
+			cins->addInit( "AGENT-ORDER", sv );
+
+			std::stringstream ss2;
+			ss2 << "AGENT-COUNT" << i + 1;
+
+			StringVec sv2( 1, ss.str() );
+			sv2.push_back( ss2.str() );
+			cins->addInit( "NEXT-AGENT-ORDER-COUNT", sv2 );
+
+			StringVec sv3( 1, ss2.str() );
+			sv3.push_back( ss.str() );
+			cins->addInit( "PREV-AGENT-ORDER-COUNT", sv3 );
+		}
+	}
+
+	if ( maxJointActionSize > 0 ) 
+	{
+		for ( int i = 0; i <= maxJointActionSize; ++i ) 
+		{
+			std::stringstream ss;
+			ss << "ATOMIC-COUNT" << i;
+			cins->addObject( ss.str(), "ATOMIC-ACTION-COUNT" );
+		}
+
+		cins->addInit( "CURRENT-ATOMIC-ACTION-COUNT", StringVec( 1, "ATOMIC-COUNT0" ) );
+
+		for ( int i = 0; i < maxJointActionSize; ++i ) {
+			std::stringstream ss, ss2;
+			ss << "ATOMIC-COUNT" << i;
+			ss2 << "ATOMIC-COUNT" << i + 1;
+
+			StringVec sv1( 1, ss.str() );
+			sv1.push_back( ss2.str() );
+			cins->addInit( "NEXT-ATOMIC-ACTION-COUNT", sv1 );
+
+			StringVec sv2( 1, ss2.str() );
+			sv2.push_back( ss.str() );
+			cins->addInit( "PREV-ATOMIC-ACTION-COUNT", sv2 );
+		}
+	}
+
+	return cins;
+}
+
+void ConcurrencyCompiler::prepareDomain( ConcurrencyDomain & d ) const
+{
+	d.parseBodies();
+	addAgentType( d );
+
+	// add no-op action that will be used in the transformation
+	if ( useAgentOrder )
+		addNoopAction( d );
+}
+
+std::shared_ptr< Domain > ConcurrencyCompiler::compileDomain( const ConcurrencyDomain & d ) const
+{
+	return createClassicalDomain( d, useAgentOrder, maxJointActionSize, inlineStatic, threads );
+}
+
+std::shared_ptr< Domain > ConcurrencyCompiler::compileSignature( const ConcurrencyDomain & d ) const
+{
+	return createClassicalSignature( d, useAgentOrder, maxJointActionSize );
+}
+
+std::shared_ptr< Instance > ConcurrencyCompiler::compileInstance( Domain & cd, const Instance & ins ) const
+{
+	return createTransformedInstance( cd, ins, useAgentOrder, maxJointActionSize );
+}
+
+} } // namespaces
@@ -1,14 +1,15 @@
 #include <parser/Domain.h>
 
 #include <multiagent/ConcurrencyGround.h>
+#include <multiagent/Scanner.h>
 
 namespace parser { namespace multiagent {
 
 void ConcurrencyGround::parse( Filereader & f, TokenStruct< std::string > & ts, pddl::Domain & d )
 {
-	f.next();
+	scanNext( f );
 
-	std::string lastToken = f.getToken();
+	std::string lastToken = scanToken( f );
 	while (!lastToken.empty()) 
 	{
 		int k = ts.index( lastToken );
@@ -18,8 +19,8 @@ void ConcurrencyGround::parse( Filereader & f, TokenStruct< std::string > & ts,
 			params.push_back( -1 );
 		}
 
-		f.next();
-		lastToken = f.getToken();
+		scanNext( f );
+		lastToken = scanToken( f );
 	}
 
 	f.assert_token( ")" );
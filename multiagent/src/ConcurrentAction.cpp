@@ -39,6 +39,12 @@ void ConcurrentAction::PDDLPrint( std::ostream & s, unsigned indent, const Token
 }
 
 void ConcurrentAction::parse( Filereader & f, TokenStruct< std::string > & ts, pddl::Domain & d )
+{
+	TokenStruct< std::string > astruct = parseHeader( f, d );
+	parseConditions( f, astruct, d );
+}
+
+TokenStruct< std::string > ConcurrentAction::parseHeader( Filereader & f, pddl::Domain & d )
 {
 	TokenStruct< std::string > astruct;
 
@@ -57,8 +63,7 @@ void ConcurrentAction::parse( Filereader & f, TokenStruct< std::string > & ts, p
 	f.assert_token( "(" );
 	astruct.append( f.parseTypedList( true, d.types ) );
 	params = d.convertTypes( astruct.types );
-
-	parseConditions( f, astruct, d );
+	return astruct;
 }
 
 
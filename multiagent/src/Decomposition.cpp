@@ -0,0 +1,254 @@
+
+#include <multiagent/ConcurrencyDomain.h>
+#include <multiagent/Decomposition.h>
+#include <multiagent/LazyBodies.h>
+#include <multiagent/MultiagentDomain.h>
+#include <multiagent/StaticPredicates.h>
+
+#include <sstream>
+
+namespace parser { namespace multiagent {
+
+using namespace pddl;
+
+enum LiteralUse { READ, ADD, DELETE };
+
+// Checks the literals of condition c of action a; returns a description of
+// the first literal that could connect facts of different components.
+static std::string checkCondition( const Domain & d, const Action & a, const std::set< unsigned > & statics,
+                                   const std::shared_ptr< Condition > & c, LiteralUse use )
+{
+	if ( !c || std::dynamic_pointer_cast< Equals >( c ) ) return "";
+
+	if ( auto n = std::dynamic_pointer_cast< Not >( c ) )
+		return checkCondition( d, a, statics, n->cond, use == ADD ? DELETE : use );
+
+	if ( auto g = std::dynamic_pointer_cast< Ground >( c ) ) {
+		if ( std::dynamic_pointer_cast< GroundFunc< double > >( c ) || std::dynamic_pointer_cast< GroundFunc< int > >( c ) ) return "";
+
+		int pred = d.preds.index( g->name );
+		if ( use == READ && pred >= 0 && statics.contains( pred ) ) return "";
+
+		bool anchored = false, all = true;
+		for ( int p : g->params ) {
+			bool param = p >= 0 && p < (int)a.params.size();
+			anchored |= param;
+			all &= param;
+		}
+		if ( use == ADD && !( anchored && all ) )
+			return "action " + a.name + " adds " + g->name + " on objects that are not parameters";
+		if ( !anchored )
+			return "action " + a.name + ( use == READ ? " reads " : " deletes " ) + g->name + " without using its parameters";
+		return "";
+	}
+
+	std::string r;
+	if ( auto n = std::dynamic_pointer_cast< And >( c ) )
+		for ( unsigned i = 0; r.empty() && i < n->conds.size(); ++i )
+			r = checkCondition( d, a, statics, n->conds[i], use );
+	else if ( auto o = std::dynamic_pointer_cast< Oneof >( c ) )
+		for ( unsigned i = 0; r.empty() && i < o->conds.size(); ++i )
+			r = checkCondition( d, a, statics, o->conds[i], use );
+	else if ( auto o = std::dynamic_pointer_cast< Or >( c ) ) {
+		r = checkCondition( d, a, statics, o->first, use );
+		if ( r.empty() ) r = checkCondition( d, a, statics, o->second, use );
+	}
+	else if ( auto f = std::dynamic_pointer_cast< Forall >( c ) ) r = checkCondition( d, a, statics, f->cond, use );
+	else if ( auto e = std::dynamic_pointer_cast< Exists >( c ) ) r = checkCondition( d, a, statics, e->cond, use );
+	else if ( auto w = std::dynamic_pointer_cast< When >( c ) ) {
+		r = checkCondition( d, a, statics, w->pars, READ );
+		if ( r.empty() ) r = checkCondition( d, a, statics, w->cond, ADD );
+	}
+	return r;
+}
+
+// returns why action a (whose first parameter is the agent) could make agents
+// of different components interact, or an empty string
+static std::string checkAction( const Domain & d, const Action & a, const std::set< unsigned > & statics )
+{
+	// the parameters must be related to the agent by facts of the state
+	UnsignedVec mf( a.params.size() );
+	for ( unsigned i = 0; i < mf.size(); ++i ) mf[i] = i;
+	for ( const auto & c : preconditionLiterals( a ) ) {
+		auto g = std::dynamic_pointer_cast< Ground >( c );
+		if ( !g || d.preds.index( g->name ) < 0 ) continue;
+		int first = -1;
+		for ( int p : g->params ) {
+			if ( p < 0 || p >= (int)mf.size() ) continue;
+			if ( first < 0 ) first = p;
+			else mf[uf( mf, p )] = uf( mf, first );
+		}
+	}
+	for ( unsigned i = 1; i < mf.size(); ++i )
+		if ( uf( mf, i ) != uf( mf, 0 ) )
+			return "parameter " + std::to_string( i ) + " of action " + a.name + " is not related to its agent";
+
+	std::string r = checkCondition( d, a, statics, a.pre, READ );
+	return r.size() ? r : checkCondition( d, a, statics, a.eff, ADD );
+}
+
+Decomposition::Decomposition( const Domain & dom, const Instance & instance )
+	: d( dom ), ins( instance )
+{
+	requireParsedConditions( d, "decomposing an instance" );
+
+	// objects and constants, with the type of each object
+	std::map< std::string, unsigned > ids;
+	std::vector< std::pair< std::string, std::string > > objects;
+	for ( const auto & t : d.types ) {
+		for ( unsigned j = 0; j < t->constants.size(); ++j )
+			ids.insert( std::make_pair( t->constants[j], ids.size() ) );
+		for ( unsigned j = 0; j < t->objects.size(); ++j ) {
+			if ( ids.insert( std::make_pair( t->objects[j], ids.size() ) ).second )
+				objects.push_back( std::make_pair( t->objects[j], t->name ) );
+		}
+	}
+
+	StringVec agents;
+	if ( d.types.index( "AGENT" ) < 0 ) reason = "the domain has no AGENT type";
+	else {
+		auto agentType = d.types.get( "AGENT" );
+		for ( unsigned i = 0; i < agentType->noObjects(); ++i )
+			agents.push_back( agentType->object( i ).first );
+	}
+
+	// concurrency constraints have no effects but they are not static: they
+	// couple the agents that do the actions they name
+	auto statics = staticPredicates( d );
+	if ( auto cd = dynamic_cast< const ConcurrencyDomain * >( &d ) )
+		for ( const auto & p : cd->cpreds )
+			statics.erase( d.preds.index( p->name ) );
+	for ( unsigned i = 0; reason.empty() && i < d.actions.size(); ++i )
+		reason = checkAction( d, *d.actions[i], statics );
+
+	if ( auto md = dynamic_cast< const MultiagentDomain * >( &d ) )
+		for ( unsigned i = 0; reason.empty() && i < md->nodes.size(); ++i )
+			if ( md->nodes[i]->params.empty() )
+				reason = "concurrency constraint " + md->nodes[i]->name + " has no parameters";
+
+	if ( reason.size() || agents.size() < 2 ) {
+		subproblems.resize( 1 );
+		subproblems[0].agents = agents;
+		subproblems[0].objects = objects;
+		subproblems[0].init = ins.init;
+		subproblems[0].goal = ins.goal;
+		return;
+	}
+
+	// connect the objects of each fact of the initial state and the goal
+	UnsignedVec mf( ids.size() );
+	for ( unsigned i = 0; i < mf.size(); ++i ) mf[i] = i;
+	auto factRoot = [&]( const Ground & g ) {
+		int root = -1;
+		for ( const auto & o : d.objectList( g ) ) {
+			unsigned x = uf( mf, ids[o] );
+			if ( root < 0 ) root = x;
+			else mf[x] = root;
+		}
+		return root;
+	};
+	for ( const auto & g : ins.init ) factRoot( *g );
+	for ( const auto & g : ins.goal ) factRoot( *g );
+
+	// one subproblem per component with agents, in the order of the agents;
+	// objects of components without agents go to the first subproblem
+	std::map< unsigned, unsigned > component;
+	for ( const auto & a : agents ) {
+		unsigned root = uf( mf, ids[a] );
+		if ( !component.contains( root ) ) {
+			component[root] = subproblems.size();
+			subproblems.push_back( Subproblem() );
+		}
+		subproblems[component[root]].agents.push_back( a );
+	}
+	auto subproblem = [&]( unsigned id ) {
+		auto it = component.find( uf( mf, id ) );
+		return it == component.end() ? 0u : it->second;
+	};
+
+	for ( const auto & o : objects )
+		subproblems[subproblem( ids[o.first] )].objects.push_back( o );
+
+	// facts without objects are static, so every subproblem keeps them
+	for ( const auto & g : ins.init ) {
+		int root = factRoot( *g );
+		if ( root < 0 ) for ( auto & s : subproblems ) s.init.push_back( g );
+		else subproblems[subproblem( root )].init.push_back( g );
+	}
+	for ( const auto & g : ins.goal ) {
+		int root = factRoot( *g );
+		if ( root < 0 ) for ( auto & s : subproblems ) s.goal.push_back( g );
+		else subproblems[subproblem( root )].goal.push_back( g );
+	}
+}
+
+void Decomposition::PDDLPrint( std::ostream & os, unsigned k ) const
+{
+	const Subproblem & s = subproblems[k];
+	os << "( DEFINE ( PROBLEM " << ins.name;
+	if ( subproblems.size() > 1 ) os << "-" << k + 1;
+	os << " )\n";
+	os << "( :DOMAIN " << d.name << " )\n";
+
+	os << "( :OBJECTS\n";
+	for ( const auto & o : s.objects )
+		os << "\t" << o.first << " - " << o.second << "\n";
+	os << ")\n";
+
+	os << "( :INIT\n";
+	for ( const auto & g : s.init ) {
+		g->PDDLPrint( os, 1, TokenStruct< std::string >(), d );
+		os << "\n";
+	}
+	os << ")\n";
+
+	os << "( :GOAL\n";
+	os << "\t( AND\n";
+	for ( const auto & g : s.goal ) {
+		g->PDDLPrint( os, 2, TokenStruct< std::string >(), d );
+		os << "\n";
+	}
+	os << "\t)\n";
+	os << ")\n";
+
+	if ( ins.metric ) os << "( :METRIC MINIMIZE ( TOTAL-COST ) )\n";
+	os << ")\n";
+}
+
+JointPlan readPlan( std::istream & is )
+{
+	JointPlan plan;
+	std::string line;
+	while ( std::getline( is, line ) ) {
+		std::istringstream ls( line );
+		unsigned step;
+		char colon;
+		if ( !( ls >> step >> colon ) || colon != ':' ) continue;
+
+		std::string action;
+		std::getline( ls >> std::ws, action );
+		if ( plan.size() <= step ) plan.resize( step + 1 );
+		plan[step].push_back( action );
+	}
+	return plan;
+}
+
+void printPlan( std::ostream & os, const JointPlan & plan )
+{
+	for ( unsigned t = 0; t < plan.size(); ++t )
+		for ( const auto & action : plan[t] )
+			os << t << ": " << action << "\n";
+}
+
+JointPlan mergePlans( const std::vector< JointPlan > & plans )
+{
+	JointPlan merged;
+	for ( const auto & plan : plans ) {
+		if ( merged.size() < plan.size() ) merged.resize( plan.size() );
+		for ( unsigned t = 0; t < plan.size(); ++t )
+			merged[t].insert( merged[t].end(), plan[t].begin(), plan[t].end() );
+	}
+	return merged;
+}
+
+} } // namespaces
@@ -0,0 +1,61 @@
+
+#include <multiagent/DeferredBlock.h>
+#include <multiagent/Parallel.h>
+
+#include <algorithm>
+
+namespace parser { namespace multiagent {
+
+DeferredBlock deferBlock( pddl::Filereader & f )
+{
+	std::streamoff next = f.f.tellg();
+	DeferredBlock b{ f.r, f.c, f.s, next };
+	unsigned depth = 1;
+	while ( true ) {
+		for ( ; f.c < f.s.size() && f.s[f.c] != ';'; ++f.c ) {
+			if ( f.s[f.c] == '(' ) ++depth;
+			else if ( f.s[f.c] == ')' && --depth == 0 ) {
+				++f.c;
+				return b;
+			}
+		}
+
+		if ( !std::getline( f.f, f.s ) ) {
+			std::cout << "Unbalanced parentheses in block starting at line " << b.row << "\n";
+			exit( 1 );
+		}
+		++f.r;
+		f.c = 0;
+	}
+}
+
+void moveTo( pddl::Filereader & f, const DeferredBlock & b )
+{
+	if ( f.r != b.row ) {
+		f.f.clear();
+		if ( b.next >= 0 ) f.f.seekg( b.next );
+		else f.f.seekg( 0, std::ios::end );
+		f.s = b.line;
+		f.r = b.row;
+	}
+	f.c = b.col;
+}
+
+void parseDeferred( const std::string & file, const std::vector< DeferredBlock > & blocks, unsigned threads, const std::function< void( pddl::Filereader &, unsigned ) > & parse )
+{
+	if ( blocks.empty() ) return;
+	threads = std::max( 1u, std::min< unsigned >( threads, blocks.size() ) );
+	unsigned chunk = ( blocks.size() + threads - 1 ) / threads;
+	unsigned chunks = ( blocks.size() + chunk - 1 ) / chunk;
+
+	parallelFor( chunks, threads, [&]( unsigned job, unsigned ) {
+		unsigned first = job * chunk, last = std::min< unsigned >( first + chunk, blocks.size() );
+		pddl::Filereader f( file );
+		for ( unsigned i = first; i < last; ++i ) {
+			moveTo( f, blocks[i] );
+			parse( f, i );
+		}
+	} );
+}
+
+} } // namespaces
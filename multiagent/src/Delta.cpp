@@ -0,0 +1,136 @@
+
+#include <multiagent/Delta.h>
+
+#include <cctype>
+
+namespace parser { namespace multiagent {
+
+using namespace pddl;
+
+void InstanceDelta::addInit( const std::string & name, const StringVec & params )
+{
+	changes.push_back( Change{ true, false, name, params } );
+}
+
+void InstanceDelta::removeInit( const std::string & name, const StringVec & params )
+{
+	changes.push_back( Change{ false, false, name, params } );
+}
+
+void InstanceDelta::addGoal( const std::string & name, const StringVec & params )
+{
+	changes.push_back( Change{ true, true, name, params } );
+}
+
+void InstanceDelta::removeGoal( const std::string & name, const StringVec & params )
+{
+	changes.push_back( Change{ false, true, name, params } );
+}
+
+void InstanceDelta::read( std::istream & is )
+{
+	std::string line;
+	while ( std::getline( is, line ) ) {
+		line = line.substr( 0, line.find( ';' ) );
+		for ( auto & c : line )
+			c = c == '(' || c == ')' ? ' ' : std::toupper( c );
+
+		std::istringstream ls( line );
+		std::string sign, section;
+		if ( !( ls >> sign ) ) continue;
+
+		Change c;
+		c.add = sign == "+";
+		ls >> section;
+		c.goal = section == "GOAL";
+		if ( ( sign != "+" && sign != "-" ) || ( section != "INIT" && section != "GOAL" ) || !( ls >> c.name ) ) {
+			std::cout << "Bad delta line: " << line << "\n";
+			exit( 1 );
+		}
+		for ( std::string p; ls >> p; ) c.params.push_back( p );
+		changes.push_back( c );
+	}
+}
+
+void InstanceDelta::print( std::ostream & os ) const
+{
+	for ( const auto & c : changes ) {
+		os << ( c.add ? "+ " : "- " ) << ( c.goal ? "goal" : "init" ) << " (" << c.name;
+		for ( const auto & p : c.params ) os << " " << p;
+		os << ")\n";
+	}
+}
+
+IncrementalInstance::IncrementalInstance( Instance & instance )
+	: ins( instance )
+{
+	for ( unsigned i = 0; i < ins.init.size(); ++i )
+		if ( ins.d.preds.index( ins.init[i]->name ) >= 0 )
+			init[fact( *ins.init[i] )] = i;
+	for ( unsigned i = 0; i < ins.goal.size(); ++i )
+		goal[fact( *ins.goal[i] )] = i;
+}
+
+unsigned IncrementalInstance::fact( const Ground & g )
+{
+	unsigned id = facts.insert( ins.d.preds.index( g.name ), g.params );
+	init.resize( facts.size(), -1 );
+	goal.resize( facts.size(), -1 );
+	return id;
+}
+
+void IncrementalInstance::erase( GroundVec & v, IntVec & index, unsigned i )
+{
+	if ( i + 1 < v.size() ) {
+		v[i] = v.back();
+		index[fact( *v[i] )] = i;
+	}
+	v.pop_back();
+}
+
+bool IncrementalInstance::objects( int p, const StringVec & names, IntVec & params ) const
+{
+	const auto & types = ins.d.preds[p]->params;
+	if ( names.size() != types.size() ) return false;
+
+	// objects are looked up as the instance parses them, but nothing is added
+	params.resize( names.size() );
+	for ( unsigned i = 0; i < names.size(); ++i ) {
+		std::pair< bool, int > o = ins.d.types[types[i]]->parseObject( names[i] );
+		if ( !o.first ) o = ins.d.types[types[i]]->parseConstant( names[i] );
+		if ( !o.first ) return false;
+		params[i] = o.second;
+	}
+	return true;
+}
+
+InstanceDelta IncrementalInstance::apply( const InstanceDelta & delta )
+{
+	InstanceDelta applied;
+	IntVec params;
+	for ( const auto & c : delta.changes ) {
+		int p = ins.d.preds.index( c.name );
+		if ( p < 0 || !objects( p, c.params, params ) ) continue;
+
+		// facts that are not in the table are not in the instance either
+		auto & ground = c.goal ? ins.goal : ins.init;
+		auto & index = c.goal ? goal : init;
+		int id = facts.find( p, params );
+		bool present = id >= 0 && index[id] >= 0;
+		if ( c.add && !present ) {
+			auto g = std::make_shared< Ground >( ins.d.preds[p], params );
+			ground.push_back( g );
+			index[fact( *g )] = ground.size() - 1;
+			applied.changes.push_back( c );
+		}
+		else if ( !c.add && present ) {
+			unsigned i = index[id];
+			index[id] = -1;
+			erase( ground, index, i );
+			applied.changes.push_back( c );
+		}
+	}
+	return applied;
+}
+
+} } // namespaces
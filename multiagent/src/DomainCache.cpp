@@ -0,0 +1,136 @@
+
+#include <multiagent/DomainCache.h>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace parser { namespace multiagent {
+
+namespace fs = std::filesystem;
+
+// 64-bit FNV-1a
+static std::uint64_t hashBytes( std::uint64_t h, const std::string & s )
+{
+	for ( unsigned char c : s ) {
+		h ^= c;
+		h *= 0x100000001b3ULL;
+	}
+	return h;
+}
+
+static fs::path entryPath( const std::string & dir, const std::string & key )
+{
+	return fs::path( dir ) / ( key + ".pddl" );
+}
+
+DomainCache::DomainCache( const std::string & directory, std::uintmax_t limit )
+	: dir( directory ), maxBytes( limit )
+{
+	std::error_code ec;
+	fs::create_directories( dir, ec );
+}
+
+std::string DomainCache::key( const std::string & domainFile, const std::string & compiler, const std::string & options )
+{
+	std::ifstream f( domainFile.c_str(), std::ios::binary );
+	if ( !f ) {
+		std::cout << "Failed to open domain file " << domainFile << "\n";
+		std::exit( 1 );
+	}
+	std::ostringstream bytes;
+	bytes << f.rdbuf();
+
+	std::ostringstream header;
+	header << FORMAT << '\0' << compiler << '\0' << options << '\0';
+
+	std::uint64_t h = hashBytes( hashBytes( 0xcbf29ce484222325ULL, header.str() ), bytes.str() );
+
+	std::ostringstream os;
+	os << std::hex;
+	os.width( 16 );
+	os.fill( '0' );
+	os << h;
+	return os.str();
+}
+
+bool DomainCache::lookup( const std::string & key, std::string & text ) const
+{
+	fs::path p = entryPath( dir, key );
+	std::ifstream f( p, std::ios::binary );
+	if ( !f ) return false;
+
+	std::ostringstream os;
+	os << f.rdbuf();
+	if ( !f.good() && !f.eof() ) return false;
+	text = os.str();
+
+	// the modification time records the last use of the entry
+	std::error_code ec;
+	fs::last_write_time( p, fs::file_time_type::clock::now(), ec );
+	return true;
+}
+
+void DomainCache::store( const std::string & key, const std::string & text ) const
+{
+	// write to a private file and rename it, so that concurrent readers
+	// never see a partially written entry
+	std::ostringstream tmp;
+	tmp << key << ".tmp" << std::hash< std::thread::id >()( std::this_thread::get_id() )
+	    << "-" << std::chrono::steady_clock::now().time_since_epoch().count();
+	fs::path t = fs::path( dir ) / tmp.str();
+	{
+		std::ofstream f( t, std::ios::binary );
+		if ( !f ) return;
+		f << text;
+		if ( !f ) {
+			f.close();
+			std::error_code ec;
+			fs::remove( t, ec );
+			return;
+		}
+	}
+
+	std::error_code ec;
+	fs::rename( t, entryPath( dir, key ), ec );
+	if ( ec ) fs::remove( t, ec );
+
+	evict();
+}
+
+void DomainCache::clear() const
+{
+	std::error_code ec;
+	for ( const auto & entry : fs::directory_iterator( dir, ec ) )
+		if ( entry.path().extension() == ".pddl" )
+			fs::remove( entry.path(), ec );
+}
+
+void DomainCache::evict() const
+{
+	typedef std::pair< fs::file_time_type, std::pair< std::uintmax_t, fs::path > > Entry;
+
+	std::error_code ec;
+	std::vector< Entry > entries;
+	std::uintmax_t total = 0;
+	for ( const auto & entry : fs::directory_iterator( dir, ec ) ) {
+		if ( entry.path().extension() != ".pddl" ) continue;
+		std::uintmax_t size = entry.file_size( ec );
+		if ( ec ) continue;
+		entries.push_back( Entry( entry.last_write_time( ec ), std::make_pair( size, entry.path() ) ) );
+		total += size;
+	}
+
+	std::sort( entries.begin(), entries.end() );
+	for ( unsigned i = 0; i < entries.size() && total > maxBytes; ++i ) {
+		if ( fs::remove( entries[i].second.second, ec ) )
+			total -= entries[i].second.first;
+	}
+}
+
+} } // namespaces
@@ -0,0 +1,197 @@
+
+#include <multiagent/FactStore.h>
+
+#include <algorithm>
+#include <numeric>
+
+namespace parser { namespace multiagent {
+
+using namespace pddl;
+
+void PredicateColumns::add( std::span< const int > args )
+{
+	for ( unsigned i = 0; i < columns.size(); ++i )
+		columns[i].push_back( args[i] );
+	++count;
+	indexes.clear();
+}
+
+void PredicateColumns::index( unsigned objects )
+{
+	indexes.assign( columns.size(), Index() );
+	for ( unsigned i = 0; i < columns.size(); ++i ) {
+		Index & x = indexes[i];
+		x.starts.assign( objects + 1, 0 );
+		for ( int o : columns[i] ) ++x.starts[o + 1];
+		std::partial_sum( x.starts.begin(), x.starts.end(), x.starts.begin() );
+
+		// rows of each object in increasing order
+		UnsignedVec next( x.starts.begin(), x.starts.end() - 1 );
+		x.rows.resize( count );
+		for ( unsigned r = 0; r < count; ++r )
+			x.rows[next[columns[i][r]]++] = r;
+	}
+}
+
+std::span< const unsigned > PredicateColumns::rows( unsigned pos, int object ) const
+{
+	const Index & x = indexes[pos];
+	if ( object < 0 || object + 1 >= (int)x.starts.size() ) return std::span< const unsigned >();
+	return std::span< const unsigned >( x.rows.data() + x.starts[object], x.starts[object + 1] - x.starts[object] );
+}
+
+unsigned PredicateColumns::estimate( std::span< const int > pattern ) const
+{
+	unsigned n = count;
+	if ( indexed() )
+		for ( unsigned i = 0; i < pattern.size(); ++i )
+			if ( pattern[i] >= 0 ) n = std::min( n, (unsigned)rows( i, pattern[i] ).size() );
+	return n;
+}
+
+UnsignedVec PredicateColumns::match( std::span< const int > pattern ) const
+{
+	// start from the smallest index bucket of the bound positions
+	int best = -1;
+	if ( indexed() )
+		for ( unsigned i = 0; i < pattern.size(); ++i )
+			if ( pattern[i] >= 0 && ( best < 0 || rows( i, pattern[i] ).size() < rows( best, pattern[best] ).size() ) )
+				best = i;
+
+	UnsignedVec result;
+	if ( best >= 0 ) {
+		auto r = rows( best, pattern[best] );
+		result.assign( r.begin(), r.end() );
+	}
+	else {
+		result.resize( count );
+		std::iota( result.begin(), result.end(), 0 );
+	}
+
+	// then filter the candidates one column at a time
+	for ( unsigned i = 0; i < pattern.size(); ++i )
+		if ( pattern[i] >= 0 && (int)i != best )
+			std::erase_if( result, [&]( unsigned r ) { return columns[i][r] != pattern[i]; } );
+	return result;
+}
+
+FactStore::FactStore( const Domain & dom, const Instance & ins )
+	: d( dom )
+{
+	for ( const auto & t : d.types ) {
+		for ( unsigned j = 0; j < t->constants.size(); ++j )
+			if ( ids.insert( std::make_pair( t->constants[j], names.size() ) ).second )
+				names.push_back( t->constants[j] );
+		for ( unsigned j = 0; j < t->objects.size(); ++j )
+			if ( ids.insert( std::make_pair( t->objects[j], names.size() ) ).second )
+				names.push_back( t->objects[j] );
+	}
+
+	for ( const auto & p : d.preds )
+		tables.emplace_back( p->params.size() );
+
+	// global id of each object of a type, computed the first time the type is used
+	std::vector< IntVec > typeIds( d.types.size() );
+	IntVec args;
+	for ( const auto & g : ins.init ) {
+		if ( std::dynamic_pointer_cast< GroundFunc< double > >( g ) || std::dynamic_pointer_cast< GroundFunc< int > >( g ) ) continue;
+		int p = d.preds.index( g->name );
+		if ( p < 0 ) continue;
+
+		args.clear();
+		for ( unsigned i = 0; i < g->params.size(); ++i ) {
+			int t = d.preds[p]->params[i], k = g->params[i];
+			if ( k < 0 ) {
+				args.push_back( objectId( d.types[t]->object( k ).first ) );
+				continue;
+			}
+			if ( typeIds[t].empty() )
+				for ( unsigned j = 0; j < d.types[t]->noObjects(); ++j )
+					typeIds[t].push_back( objectId( d.types[t]->object( j ).first ) );
+			args.push_back( typeIds[t][k] );
+		}
+		tables[p].add( args );
+	}
+
+	for ( auto & t : tables ) t.index( names.size() );
+}
+
+int FactStore::objectId( const std::string & s ) const
+{
+	auto it = ids.find( s );
+	return it == ids.end() ? -1 : it->second;
+}
+
+JoinAtom FactStore::atom( const Ground & g ) const
+{
+	JoinAtom a;
+	a.pred = d.preds.index( g.name );
+	if ( a.pred < 0 ) {
+		std::cout << "Unknown predicate " << g.name << " in a join\n";
+		exit( 1 );
+	}
+	for ( unsigned i = 0; i < g.params.size(); ++i ) {
+		int k = g.params[i];
+		a.args.push_back( k >= 0 ? k : -1 - objectId( d.types[d.preds[a.pred]->params[i]]->object( k ).first ) );
+	}
+	return a;
+}
+
+void FactStore::join( const std::vector< JoinAtom > & atoms, unsigned vars, const std::function< void( std::span< const int > ) > & f ) const
+{
+	std::vector< bool > done( atoms.size(), false );
+	IntVec binding( vars, -1 );
+	join( atoms, done, binding, f );
+}
+
+void FactStore::join( const std::vector< JoinAtom > & atoms, std::vector< bool > & done, IntVec & binding,
+                      const std::function< void( std::span< const int > ) > & f ) const
+{
+	auto pattern = [&]( const JoinAtom & a ) {
+		IntVec p;
+		for ( int k : a.args ) p.push_back( k >= 0 ? binding[k] : -1 - k );
+		return p;
+	};
+
+	// the atom with the fewest candidate rows
+	int best = -1;
+	unsigned size = 0;
+	for ( unsigned i = 0; i < atoms.size(); ++i ) {
+		if ( done[i] ) continue;
+		unsigned n = tables[atoms[i].pred].estimate( pattern( atoms[i] ) );
+		if ( best < 0 || n < size ) {
+			best = i;
+			size = n;
+		}
+	}
+	if ( best < 0 ) {
+		f( binding );
+		return;
+	}
+	if ( size == 0 ) return;
+
+	const JoinAtom & a = atoms[best];
+	const PredicateColumns & t = tables[a.pred];
+	done[best] = true;
+	IntVec bound;
+	for ( unsigned r : t.match( pattern( a ) ) ) {
+		// bind the free variables of the atom; a variable that appears twice
+		// is bound by its first position and checked at the others
+		bool ok = true;
+		for ( unsigned i = 0; ok && i < a.args.size(); ++i ) {
+			int k = a.args[i];
+			if ( k < 0 ) continue;
+			if ( binding[k] < 0 ) {
+				binding[k] = t.at( r, i );
+				bound.push_back( k );
+			}
+			else ok = binding[k] == t.at( r, i );
+		}
+		if ( ok ) join( atoms, done, binding, f );
+		for ( int k : bound ) binding[k] = -1;
+		bound.clear();
+	}
+	done[best] = false;
+}
+
+} } // namespaces
@@ -0,0 +1,96 @@
+
+#include <multiagent/FactTable.h>
+
+#include <algorithm>
+
+namespace parser { namespace multiagent {
+
+using namespace pddl;
+
+size_t FactTable::hash( int pred, std::span< const int > args )
+{
+	size_t h = std::hash< int >()( pred );
+	for ( int a : args ) h = h * 1000003 ^ std::hash< int >()( a );
+	return h;
+}
+
+int FactTable::find( int pred, std::span< const int > args ) const
+{
+	auto range = index.equal_range( hash( pred, args ) );
+	for ( auto it = range.first; it != range.second; ++it ) {
+		unsigned id = it->second;
+		auto a = this->args( id );
+		if ( preds[id] == pred && std::equal( a.begin(), a.end(), args.begin(), args.end() ) )
+			return id;
+	}
+	return -1;
+}
+
+unsigned FactTable::insert( int pred, std::span< const int > args )
+{
+	int id = find( pred, args );
+	if ( id >= 0 ) return id;
+
+	preds.push_back( pred );
+	pool.insert( pool.end(), args.begin(), args.end() );
+	starts.push_back( pool.size() );
+	index.emplace( hash( pred, args ), preds.size() - 1 );
+	return preds.size() - 1;
+}
+
+// whether objects and constants have the same positions in both types
+static bool sameObjects( const Type & a, const Type & b )
+{
+	if ( a.noObjects() != b.noObjects() || a.constants.size() != b.constants.size() ) return false;
+	for ( unsigned i = 0; i < a.noObjects(); ++i )
+		if ( a.object( i ).first != b.object( i ).first ) return false;
+	for ( unsigned i = 0; i < a.constants.size(); ++i )
+		if ( a.constants[i] != b.constants[i] ) return false;
+	return true;
+}
+
+FactCopier::FactCopier( const Domain & source, Domain & target )
+	: from( source ), to( target ), preds( source.preds.size(), -1 ), sameIds( source.preds.size(), false )
+{
+	std::map< std::pair< int, int >, bool > types; // sameObjects of each pair of types
+	for ( unsigned p = 0; p < from.preds.size(); ++p ) {
+		preds[p] = to.preds.index( from.preds[p]->name );
+		if ( preds[p] < 0 ) continue;
+
+		const IntVec & a = from.preds[p]->params, & b = to.preds[preds[p]]->params;
+		bool same = a.size() == b.size();
+		for ( unsigned i = 0; same && i < a.size(); ++i ) {
+			auto it = types.find( std::make_pair( a[i], b[i] ) );
+			if ( it == types.end() )
+				it = types.emplace( std::make_pair( a[i], b[i] ), sameObjects( *from.types[a[i]], *to.types[b[i]] ) ).first;
+			same = it->second;
+		}
+		sameIds[p] = same;
+	}
+}
+
+bool FactCopier::copy( const Ground & g, Instance & ins, bool goal ) const
+{
+	int p = from.preds.index( g.name );
+	if ( p < 0 || preds[p] < 0 ) return false;
+
+	if ( sameIds[p] ) {
+		auto c = std::make_shared< Ground >( to.preds[preds[p]], g.params );
+		( goal ? ins.goal : ins.init ).push_back( c );
+	}
+	else if ( goal ) ins.addGoal( g.name, from.objectList( g ) );
+	else ins.addInit( g.name, from.objectList( g ) );
+	return true;
+}
+
+bool FactCopier::copyInit( const Ground & g, Instance & ins ) const
+{
+	return copy( g, ins, false );
+}
+
+bool FactCopier::copyGoal( const Ground & g, Instance & ins ) const
+{
+	return copy( g, ins, true );
+}
+
+} } // namespaces
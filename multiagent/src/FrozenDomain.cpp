@@ -0,0 +1,197 @@
+
+#include <multiagent/ConcurrencyDomain.h>
+#include <multiagent/FrozenDomain.h>
+#include <multiagent/LazyBodies.h>
+#include <multiagent/MultiagentDomain.h>
+
+#include <sstream>
+
+namespace parser { namespace multiagent {
+
+using namespace pddl;
+
+template < typename T, typename V >
+static FrozenDomain::Range append( std::vector< T > & parts, const V & v )
+{
+	FrozenDomain::Range r{ unsigned( parts.size() ), unsigned( v.size() ) };
+	parts.insert( parts.end(), v.begin(), v.end() );
+	return r;
+}
+
+static FrozenDomain::Symbol symbol( FrozenDomain & fd, const ParamCond & c )
+{
+	FrozenDomain::Symbol s;
+	s.name = c.name;
+	s.params = append( fd.params, c.params );
+	return s;
+}
+
+// Adds the nodes of condition c (children first), in which vars variables
+// are in scope, and returns the index of its root
+static int freezeCondition( FrozenDomain & fd, const Domain & d, const std::shared_ptr< Condition > & c, unsigned vars )
+{
+	if ( !c ) return -1;
+
+	FrozenDomain::Node n;
+	UnsignedVec children;
+	// operands of connectives with a fixed number of them keep their slot
+	auto add = [&]( const std::shared_ptr< Condition > & child, unsigned scope ) {
+		int k = freezeCondition( fd, d, child, scope );
+		children.push_back( k >= 0 ? k : FrozenDomain::none );
+	};
+	auto addAll = [&]( const CondVec & v ) {
+		for ( const auto & child : v ) {
+			int k = freezeCondition( fd, d, child, vars );
+			if ( k >= 0 ) children.push_back( k );
+		}
+	};
+
+	if ( auto e = std::dynamic_pointer_cast< Equals >( c ) ) {
+		n.kind = FrozenDomain::EQUALS;
+		n.args = append( fd.args, e->params );
+	}
+	else if ( auto g = std::dynamic_pointer_cast< Ground >( c ) ) {
+		n.kind = FrozenDomain::GROUND;
+		n.symbol = d.preds.index( g->name );
+		n.args = append( fd.args, g->params );
+	}
+	else if ( auto x = std::dynamic_pointer_cast< Not >( c ) ) {
+		n.kind = FrozenDomain::NOT;
+		add( x->cond, vars );
+	}
+	else if ( auto a = std::dynamic_pointer_cast< And >( c ) ) {
+		n.kind = FrozenDomain::AND;
+		addAll( a->conds );
+	}
+	else if ( auto o = std::dynamic_pointer_cast< Or >( c ) ) {
+		n.kind = FrozenDomain::OR;
+		add( o->first, vars );
+		add( o->second, vars );
+	}
+	else if ( auto o = std::dynamic_pointer_cast< Oneof >( c ) ) {
+		n.kind = FrozenDomain::ONEOF;
+		addAll( o->conds );
+	}
+	else if ( auto f = std::dynamic_pointer_cast< Forall >( c ) ) {
+		n.kind = FrozenDomain::FORALL;
+		n.args = append( fd.args, f->params );
+		add( f->cond, vars + f->params.size() );
+	}
+	else if ( auto e = std::dynamic_pointer_cast< Exists >( c ) ) {
+		n.kind = FrozenDomain::EXISTS;
+		n.args = append( fd.args, e->params );
+		add( e->cond, vars + e->params.size() );
+	}
+	else if ( auto w = std::dynamic_pointer_cast< When >( c ) ) {
+		n.kind = FrozenDomain::WHEN;
+		add( w->pars, vars );
+		add( w->cond, vars );
+	}
+	else if ( auto i = std::dynamic_pointer_cast< Increase >( c ) ) {
+		n.kind = FrozenDomain::INCREASE;
+		TokenStruct< std::string > ts;
+		for ( unsigned k = 0; k < vars; ++k )
+			ts.insert( "?" + std::to_string( k ) );
+		std::ostringstream os;
+		i->PDDLPrint( os, 0, ts, d );
+		n.symbol = fd.increases.size();
+		fd.increases.push_back( os.str() );
+	}
+	else {
+		std::cout << "Cannot freeze condition " << c << "\n";
+		exit( 1 );
+	}
+
+	n.children = append( fd.children, children );
+	fd.nodes.push_back( n );
+	return fd.nodes.size() - 1;
+}
+
+std::shared_ptr< const FrozenDomain > freeze( const Domain & d, bool signature )
+{
+	if ( !signature ) requireParsedConditions( d, "freezing it" );
+
+	auto fd = std::make_shared< FrozenDomain >();
+	fd->name = d.name;
+	fd->typed = d.typed;
+	fd->multiagent = fd->unfact = fd->fact = fd->net = false;
+
+	auto md = dynamic_cast< const MultiagentDomain * >( &d );
+	auto cd = dynamic_cast< const ConcurrencyDomain * >( &d );
+	if ( md ) {
+		fd->multiagent = md->multiagent;
+		fd->unfact = md->unfact;
+		fd->fact = md->fact;
+		fd->net = md->net;
+	}
+	else if ( cd ) {
+		fd->multiagent = cd->multiagent;
+		fd->unfact = cd->unfact;
+		fd->fact = cd->fact;
+	}
+
+	for ( const auto & t : d.types ) {
+		auto super = t->supertype.lock();
+		fd->types.push_back( FrozenDomain::Type{ t->name, super ? d.types.index( super->name ) : -1, append( fd->constants, t->constants ) } );
+		fd->typeIndices[t->name] = fd->types.size() - 1;
+	}
+
+	for ( const auto & p : d.preds ) {
+		fd->preds.push_back( symbol( *fd, *p ) );
+		fd->preds.back().concurrency = cd && cd->cpreds.index( p->name ) >= 0;
+		fd->predIndices[p->name] = fd->preds.size() - 1;
+	}
+	for ( const auto & f : d.funcs )
+		fd->funcs.push_back( symbol( *fd, *f ) );
+
+	for ( const auto & a : d.actions ) {
+		FrozenDomain::Action fa;
+		fa.signature = symbol( *fd, *a );
+		fa.pre = freezeCondition( *fd, d, a->pre, a->params.size() );
+		fa.eff = freezeCondition( *fd, d, a->eff, a->params.size() );
+		fd->actions.push_back( fa );
+		fd->actionIndices[a->name] = fd->actions.size() - 1;
+	}
+
+	if ( md ) {
+		for ( const auto & n : md->nodes ) {
+			std::vector< FrozenDomain::Template > templates;
+			for ( const auto & t : n->templates )
+				templates.push_back( FrozenDomain::Template{ d.actions.index( t->name ), append( fd->args, t->params ) } );
+			fd->network.push_back( FrozenDomain::NetworkNode{ symbol( *fd, *n ), n->lower, n->upper, append( fd->templates, templates ) } );
+		}
+		fd->edges = md->edges;
+	}
+
+	return fd;
+}
+
+static int find( const std::map< std::string, int > & m, const std::string & s )
+{
+	auto it = m.find( s );
+	return it == m.end() ? -1 : it->second;
+}
+
+int FrozenDomain::typeIndex( const std::string & s ) const
+{
+	return find( typeIndices, s );
+}
+
+int FrozenDomain::predIndex( const std::string & s ) const
+{
+	return find( predIndices, s );
+}
+
+int FrozenDomain::actionIndex( const std::string & s ) const
+{
+	return find( actionIndices, s );
+}
+
+bool FrozenDomain::subtype( int t, int u ) const
+{
+	for ( ; t >= 0; t = types[t].supertype )
+		if ( t == u ) return true;
+	return false;
+}
+
+} } // namespaces
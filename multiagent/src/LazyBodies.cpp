@@ -0,0 +1,71 @@
+
+#include <multiagent/AgentAction.h>
+#include <multiagent/ConcurrencyDomain.h>
+#include <multiagent/ConcurrentAction.h>
+#include <multiagent/LazyBodies.h>
+#include <multiagent/MultiagentDomain.h>
+
+#include <algorithm>
+
+namespace parser { namespace multiagent {
+
+using namespace pddl;
+
+void LazyBodies::defer( const std::shared_ptr< Action > & a, Filereader & f, Domain & d )
+{
+	Body b;
+	b.action = a;
+	if ( auto ca = std::dynamic_pointer_cast< ConcurrentAction >( a ) ) b.params = ca->parseHeader( f, d );
+	else if ( auto aa = std::dynamic_pointer_cast< AgentAction >( a ) ) b.params = aa->parseHeader( f, d );
+	else {
+		f.next();
+		f.assert_token( ":PARAMETERS" );
+		f.assert_token( "(" );
+		b.params = f.parseTypedList( true, d.types );
+		a->params = d.convertTypes( b.params.types );
+	}
+	b.block = deferBlock( f );
+	bodies[a->name] = b;
+}
+
+void LazyBodies::parse( const std::string & action, Domain & d )
+{
+	auto it = bodies.find( action );
+	if ( it == bodies.end() ) return;
+
+	// only the block of the action is read, from where it starts in the file
+	Body & b = it->second;
+	Filereader f( file );
+	moveTo( f, b.block );
+	b.action->parseConditions( f, b.params, d );
+	bodies.erase( it );
+}
+
+void LazyBodies::parseAll( Domain & d, unsigned threads )
+{
+	// parseDeferred takes the blocks in the order of the file
+	std::vector< Body * > v;
+	for ( auto & [name, b] : bodies ) v.push_back( &b );
+	std::sort( v.begin(), v.end(), []( const Body * x, const Body * y ) {
+		return std::make_pair( x->block.row, x->block.col ) < std::make_pair( y->block.row, y->block.col );
+	} );
+
+	std::vector< DeferredBlock > blocks;
+	for ( const Body * b : v ) blocks.push_back( b->block );
+	parseDeferred( file, blocks, threads, [&]( Filereader & f, unsigned i ) {
+		v[i]->action->parseConditions( f, v[i]->params, d );
+	} );
+	bodies.clear();
+}
+
+void requireParsedConditions( const Domain & d, const std::string & step )
+{
+	auto md = dynamic_cast< const MultiagentDomain * >( &d );
+	auto cd = dynamic_cast< const ConcurrencyDomain * >( &d );
+	if ( ( md && !md->lazyBodies.empty() ) || ( cd && !cd->lazyBodies.empty() ) ) {
+		std::cout << "The conditions of the actions of a lazy domain must be parsed before " << step << "\n";
+		exit( 1 );
+	}
+}
+
+} } // namespaces
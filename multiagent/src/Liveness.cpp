@@ -0,0 +1,153 @@
+
+#include <multiagent/LazyBodies.h>
+#include <multiagent/Liveness.h>
+
+namespace parser { namespace multiagent {
+
+using namespace pddl;
+
+// adds the predicates read by condition c to names
+static void readPredicates( const std::shared_ptr< Condition > & c, std::set< std::string > & names )
+{
+	if ( !c ) return;
+	if ( std::dynamic_pointer_cast< Equals >( c ) ) return;
+	if ( auto g = std::dynamic_pointer_cast< Ground >( c ) ) names.insert( g->name );
+	else if ( auto n = std::dynamic_pointer_cast< Not >( c ) ) readPredicates( n->cond, names );
+	else if ( auto a = std::dynamic_pointer_cast< And >( c ) )
+		for ( const auto & child : a->conds ) readPredicates( child, names );
+	else if ( auto o = std::dynamic_pointer_cast< Or >( c ) ) {
+		readPredicates( o->first, names );
+		readPredicates( o->second, names );
+	}
+	else if ( auto f = std::dynamic_pointer_cast< Forall >( c ) ) readPredicates( f->cond, names );
+	else if ( auto e = std::dynamic_pointer_cast< Exists >( c ) ) readPredicates( e->cond, names );
+	else if ( auto w = std::dynamic_pointer_cast< When >( c ) ) {
+		readPredicates( w->pars, names );
+		readPredicates( w->cond, names );
+	}
+	else if ( auto o = std::dynamic_pointer_cast< Oneof >( c ) )
+		for ( const auto & child : o->conds ) readPredicates( child, names );
+}
+
+// adds the predicates read by the conditional effects in effect c to names
+static void effectConditions( const std::shared_ptr< Condition > & c, std::set< std::string > & names )
+{
+	if ( auto a = std::dynamic_pointer_cast< And >( c ) )
+		for ( const auto & child : a->conds ) effectConditions( child, names );
+	else if ( auto f = std::dynamic_pointer_cast< Forall >( c ) ) effectConditions( f->cond, names );
+	else if ( auto w = std::dynamic_pointer_cast< When >( c ) ) {
+		readPredicates( w->pars, names );
+		effectConditions( w->cond, names );
+	}
+	// a nondeterministic effect is kept as a whole
+	else if ( std::dynamic_pointer_cast< Oneof >( c ) ) readPredicates( c, names );
+}
+
+// true if effect c adds or deletes a predicate in names
+static bool affects( const std::shared_ptr< Condition > & c, const std::set< std::string > & names )
+{
+	if ( !c ) return false;
+	if ( auto g = std::dynamic_pointer_cast< Ground >( c ) ) return names.contains( g->name );
+	if ( auto n = std::dynamic_pointer_cast< Not >( c ) ) return n->cond && names.contains( n->cond->name );
+	if ( auto a = std::dynamic_pointer_cast< And >( c ) ) {
+		for ( const auto & child : a->conds )
+			if ( affects( child, names ) ) return true;
+		return false;
+	}
+	if ( auto f = std::dynamic_pointer_cast< Forall >( c ) ) return affects( f->cond, names );
+	if ( auto w = std::dynamic_pointer_cast< When >( c ) ) return affects( w->cond, names );
+	if ( std::dynamic_pointer_cast< Oneof >( c ) ) return true;
+	return false; // numeric effects only change the cost
+}
+
+// Returns effect c without the effects on predicates outside names, or
+// nullptr if nothing remains. Nodes are never modified in place since the
+// compilers may share them between actions.
+static std::shared_ptr< Condition > pruneEffect( const std::shared_ptr< Condition > & c, const std::set< std::string > & names )
+{
+	if ( !c ) return c;
+	if ( auto g = std::dynamic_pointer_cast< Ground >( c ) ) return names.contains( g->name ) ? c : nullptr;
+	if ( auto n = std::dynamic_pointer_cast< Not >( c ) ) return n->cond && names.contains( n->cond->name ) ? c : nullptr;
+	if ( auto a = std::dynamic_pointer_cast< And >( c ) ) {
+		auto na = std::make_shared< And >();
+		for ( const auto & child : a->conds )
+			if ( auto p = pruneEffect( child, names ) ) na->add( p );
+		return na->conds.empty() ? nullptr : na;
+	}
+	if ( auto f = std::dynamic_pointer_cast< Forall >( c ) ) {
+		auto body = pruneEffect( f->cond, names );
+		if ( !body ) return nullptr;
+		auto nf = std::make_shared< Forall >();
+		nf->name = f->name;
+		nf->params = f->params;
+		nf->cond = body;
+		return nf;
+	}
+	if ( auto w = std::dynamic_pointer_cast< When >( c ) ) {
+		auto body = pruneEffect( w->cond, names );
+		if ( !body ) return nullptr;
+		auto nw = std::make_shared< When >();
+		nw->pars = w->pars;
+		nw->cond = body;
+		return nw;
+	}
+	return c;
+}
+
+Liveness::Liveness( const Domain & cd, const Instance & cins )
+	: actionsBefore( 0 ), actionsAfter( 0 ), predicatesBefore( 0 ), predicatesAfter( 0 ), initBefore( 0 ), initAfter( 0 )
+{
+	requireParsedConditions( cd, "eliminating dead code" );
+
+	for ( const auto & g : cins.goal ) live.insert( g->name );
+
+	// fixpoint: actions become relevant as the set of live predicates grows
+	std::vector< bool > relevant( cd.actions.size(), false );
+	for ( bool changed = true; changed; ) {
+		changed = false;
+		for ( unsigned i = 0; i < cd.actions.size(); ++i ) {
+			if ( relevant[i] || !affects( cd.actions[i]->eff, live ) ) continue;
+			relevant[i] = changed = true;
+			readPredicates( cd.actions[i]->pre, live );
+			effectConditions( cd.actions[i]->eff, live );
+		}
+	}
+}
+
+void Liveness::eliminate( Domain & cd, Instance & cins )
+{
+	TokenStruct< std::shared_ptr< Action > > actions;
+	for ( const auto & a : cd.actions ) {
+		if ( !affects( a->eff, live ) ) continue;
+		// numeric effects are kept so that the metric does not change
+		a->eff = pruneEffect( a->eff, live );
+		if ( !a->eff ) a->eff = std::make_shared< And >();
+		actions.insert( a );
+	}
+	actionsBefore += cd.actions.size();
+	actionsAfter += actions.size();
+	cd.actions = actions;
+
+	TokenStruct< std::shared_ptr< Lifted > > preds;
+	for ( const auto & p : cd.preds )
+		if ( live.contains( p->name ) ) preds.insert( p );
+	predicatesBefore += cd.preds.size();
+	predicatesAfter += preds.size();
+	cd.preds = preds;
+
+	GroundVec init;
+	for ( const auto & g : cins.init )
+		if ( live.contains( g->name ) || cd.funcs.index( g->name ) >= 0 ) init.push_back( g );
+	initBefore += cins.init.size();
+	initAfter += init.size();
+	cins.init = init;
+}
+
+void Liveness::report( std::ostream & os ) const
+{
+	os << "actions: " << actionsBefore << " -> " << actionsAfter;
+	os << ", predicates: " << predicatesBefore << " -> " << predicatesAfter;
+	os << ", initial facts: " << initBefore << " -> " << initAfter << "\n";
+}
+
+} } // namespaces
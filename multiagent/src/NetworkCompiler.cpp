@@ -0,0 +1,527 @@
+
+#include <multiagent/NetworkCompiler.h>
+#include <multiagent/FactTable.h>
+#include <multiagent/SharedConditions.h>
+#include <multiagent/StaticPredicates.h>
+#include <multiagent/Symmetry.h>
+
+namespace parser { namespace multiagent {
+
+using namespace pddl;
+
+NetworkCompiler::NetworkCompiler( const MultiagentDomain & dom, bool staticInlining, bool bounded, bool symmetry )
+	: d( dom ), inlineStatic( staticInlining ), boundedCounters( bounded ), symmetryBreaking( symmetry ), staticPreds( staticPredicates( dom ) )
+{
+	requireParsedConditions( d, "compiling it" );
+
+	// Identify problematic fluents (preconditions deleted by agents)
+	// For now, disregard edges
+
+	for ( unsigned i = 0; i < d.nodes.size(); ++i ) 
+	{
+		for ( unsigned j = 0; d.nodes[i]->upper > 1 && j < d.nodes[i]->templates.size(); ++j ) 
+		{
+			auto a = d.actions[d.actions.index( d.nodes[i]->templates[j]->name )];
+			const auto dels = a->deleteEffects();
+
+			for (auto& del : dels)
+			{
+				if ( std::ranges::find(del->params, 0 ) == del->params.end() &&
+				     deletes(*del, *d.nodes[i], j ) ) {
+					prob.insert( d.preds.index(del->name ) );
+				}
+			}
+		}
+	}
+
+	for ( unsigned i = 0; i < d.mf.size(); ++i )
+		ccs[d.mf[i]].push_back( i );
+
+	inEdges.resize( d.nodes.size() );
+	outEdges.resize( d.nodes.size() );
+	for ( unsigned k = 0; k < d.edges.size(); ++k ) {
+		outEdges[d.edges[k].first].push_back( k );
+		inEdges[d.edges[k].second].push_back( k );
+	}
+}
+
+bool NetworkCompiler::deletes( const Ground& ground, const NetworkNode& n, unsigned k ) const
+{
+	for ( unsigned i = 0; i < n.templates.size(); ++i )
+		if ( i != k ) {
+			auto a = d.actions[d.actions.index( n.templates[i]->name )];
+			auto pres = a->precons();
+			for (const auto& pre : pres)
+			{
+				auto g = std::dynamic_pointer_cast<Ground>(pre);
+				if ( g && g->name == ground.name &&
+				     std::ranges::find(g->params, 0 ) == g->params.end() )
+					return true;
+			}
+		}
+	return false;
+}
+
+bool NetworkCompiler::addEff( Domain& cd, Action& a, const std::shared_ptr<Condition>& c ) const
+{
+	auto n = std::dynamic_pointer_cast<Not>(c);
+	auto g = std::dynamic_pointer_cast<Ground>(c);
+	if ( n && prob.contains( d.preds.index( n->cond->name ) )) {
+		cd.addEff( false, a.name, "NEG-" + n->cond->name, n->cond->params );
+		return true;
+	}
+	if ( g && prob.contains( d.preds.index( g->name ) )) {
+		cd.addEff( false, a.name, "POS-" + g->name, g->params );
+		return true;
+	}
+	
+	if ( n )
+		cd.addEff( true, a.name, n->cond->name, n->cond->params );
+	else if ( g )
+		cd.addEff( false, a.name, g->name, g->params );
+	else if ( c ) 
+	{
+		if ( !a.eff ) a.eff = std::make_shared<And>();
+		const auto aa = std::dynamic_pointer_cast<And>(a.eff);
+		aa->add( c );
+	}
+
+	return false;
+}
+
+std::shared_ptr< Condition > NetworkCompiler::staticPrecondition( const Domain & cd, unsigned x ) const
+{
+	const NetworkNode & n = *d.nodes[x];
+	unsigned size = n.params.size();
+
+	std::shared_ptr< Condition > result;
+	for ( const auto & t : n.templates )
+	{
+		auto a = d.actions[d.actions.index( t->name )];
+
+		// action parameter -> parameter of START- (node parameters first,
+		// then the existentially quantified ones)
+		std::map< int, int > vars;
+		for ( unsigned i = 0; i < t->params.size(); ++i )
+			vars.emplace( t->params[i], i );
+		StringVec existsTypes;
+
+		auto conj = std::make_shared<And>();
+		for ( const auto & l : preconditionLiterals( *a ) )
+		{
+			auto g = std::dynamic_pointer_cast<Ground>( l );
+			int pred = g ? d.preds.index( g->name ) : -1;
+			if ( pred < 0 || !staticPreds.contains( pred ) ) continue;
+
+			IntVec params;
+			for ( int p : g->params )
+			{
+				if ( p < 0 ) params.push_back( p );
+				else {
+					auto it = vars.find( p );
+					if ( it == vars.end() ) {
+						it = vars.emplace( p, size + existsTypes.size() ).first;
+						existsTypes.push_back( d.types[a->params[p]]->name );
+					}
+					params.push_back( it->second );
+				}
+			}
+			conj->add( std::make_shared<Ground>( cd.preds.get( g->name ), params ) );
+		}
+
+		if ( conj->conds.empty() ) return nullptr;
+
+		std::shared_ptr< Condition > c = conj;
+		if ( existsTypes.size() )
+		{
+			auto e = std::make_shared<Exists>();
+			e->params = cd.convertTypes( existsTypes );
+			e->cond = conj;
+			c = e;
+		}
+
+		if ( result )
+		{
+			auto o = std::make_shared<Or>();
+			o->first = result;
+			o->second = c;
+			c = o;
+		}
+		result = c;
+	}
+	return result;
+}
+
+unsigned NetworkCompiler::counterBound( unsigned x ) const
+{
+	// an infinite upper bound is stored as 1000000 (see NetworkNode)
+	return d.nodes[x]->upper < 1000000 ? d.nodes[x]->upper : d.nodes[x]->lower;
+}
+
+std::string NetworkCompiler::counter( unsigned x, unsigned k ) const
+{
+	return "COUNT-" + d.nodes[x]->name + "-" + std::to_string( k );
+}
+
+std::shared_ptr< Domain > NetworkCompiler::compileSignature() const
+{
+	auto cd = std::make_shared<Domain>();
+	cd->name = d.name;
+	cd->condeffects = cd->cons = cd->typed = true;
+
+	// Add types
+	cd->setTypes( d.copyTypes() );
+	if ( !boundedCounters ) {
+		cd->createType( "AGENT-COUNT" );
+
+		// Add constants
+		cd->createConstant( "ACOUNT-0", "AGENT-COUNT" );
+	}
+
+	// Add predicates
+	for ( unsigned i = 0; i < d.preds.size(); ++i ) 
+	{
+		cd->createPredicate(d.preds[i]->name, d.typeList(*d.preds[i]));
+		if ( prob.contains( i )) 
+		{
+			cd->createPredicate( "POS-" + d.preds[i]->name );
+			cd->createPredicate( "NEG-" + d.preds[i]->name );
+		}
+	}
+	cd->createPredicate( "AFREE" );
+	cd->createPredicate( "ATEMP" );
+	cd->createPredicate( "TAKEN", StringVec( 1, "AGENT" ) );
+	if ( !boundedCounters )
+		cd->createPredicate( "CONSEC", StringVec( 2, "AGENT-COUNT" ) );
+	if ( symmetryBreaking ) {
+		cd->createPredicate( "ACTED", StringVec( 1, "AGENT" ) );
+		cd->createPredicate( "SYM-PREV", StringVec( 2, "AGENT" ) );
+	}
+	for ( unsigned i = 0; i < d.nodes.size(); ++i ) 
+	{
+		auto j = ccs.find( d.mf[i] );
+		if ( j->second.size() > 1 || d.nodes[i]->upper > 1 ) {
+			cd->createPredicate( "ACTIVE-" + d.nodes[i]->name, d.typeList(*d.nodes[i]));
+			if ( boundedCounters ) {
+				for ( unsigned k = 0; k <= counterBound( i ); ++k )
+					cd->createPredicate( counter( i, k ) );
+			}
+			else {
+				cd->createPredicate( "COUNT-" + d.nodes[i]->name, StringVec( 1, "AGENT-COUNT" ) );
+				cd->createPredicate( "SAT-" + d.nodes[i]->name, StringVec( 1, "AGENT-COUNT" ) );
+			}
+		}
+		if ( j->second.size() > 1 ) 
+		{
+			cd->createPredicate( "USED-" + d.nodes[i]->name );
+			cd->createPredicate( "DONE-" + d.nodes[i]->name );
+			cd->createPredicate( "SKIPPED-" + d.nodes[i]->name );
+		}
+	}
+
+	return cd;
+}
+
+std::shared_ptr< Domain > NetworkCompiler::compileDomain() const
+{
+	auto cd = compileSignature();
+
+	// Add actions
+	for (auto& cc : ccs)
+	{
+		std::set< unsigned > visited;
+		for ( unsigned j = 0; j < cc.second.size(); ++j ) 
+		{
+			int x = cc.second[j];
+			visited.insert( x );
+
+			if (cc.second.size() > 1 || d.nodes[x]->upper > 1 ) {
+				std::string name = "START-" + d.nodes[x]->name;
+				unsigned size = d.nodes[x]->params.size();
+				auto start = cd->createAction( name, d.typeList( *d.nodes[x] ) );
+
+				if ( j > 0 )
+				{
+					for ( unsigned k : inEdges[x] )
+					{
+						auto it = visited.find( d.edges[k].first );
+						if ( it != visited.end() )
+							cd->addPre( false, name, "DONE-" + d.nodes[d.edges[k].first]->name );
+					}
+					cd->addOrPre( name, "DONE-" + d.nodes[cc.second[j - 1]]->name, "SKIPPED-" + d.nodes[cc.second[j - 1]]->name );
+					cd->addPre( false, name, "ACTIVE-" + d.nodes[cc.second[j - 1]]->name, incvec( 0, size ) );
+					cd->addPre( true, name, "USED-" + d.nodes[x]->name );
+					
+				}
+				else cd->addPre( false, name, "AFREE" );
+
+				if ( j < 1 ) cd->addEff( true, name, "AFREE" );
+				cd->addEff( false, name, "ACTIVE-" + d.nodes[x]->name, incvec( 0, size ) );
+				if ( boundedCounters ) cd->addEff( false, name, counter( x, 0 ) );
+				else cd->addEff( false, name, "COUNT-" + d.nodes[x]->name, IntVec( 1, -1 ) );
+				if (cc.second.size() > 1 )
+					cd->addEff( false, name, "USED-" + d.nodes[x]->name );
+
+				// if the node needs at least one action, the static facts that all its
+				// actions need restrict the parameters of START- without losing plans
+				if ( inlineStatic && d.nodes[x]->lower > 0 )
+					if ( auto c = staticPrecondition( *cd, x ) )
+						std::dynamic_pointer_cast<And>( start->pre )->add( c );
+			}
+
+			if (cc.second.size() > 1 ) {
+				std::string name = "SKIP-" + d.nodes[x]->name;
+				unsigned size = d.nodes[x]->params.size();
+				cd->createAction( name, d.typeList(*d.nodes[x]));
+
+				if ( j > 0 ) {
+					for ( unsigned k : outEdges[x] ) {
+						auto it = visited.find( d.edges[k].second );
+						if ( it != visited.end() )
+							cd->addPre( false, name, "SKIPPED-" + d.nodes[d.edges[k].second]->name );
+					}
+					cd->addOrPre( name, "DONE-" + d.nodes[cc.second[j - 1]]->name, "SKIPPED-" + d.nodes[cc.second[j - 1]]->name );
+					cd->addPre( false, name, "ACTIVE-" + d.nodes[cc.second[j - 1]]->name, incvec( 0, size ) );
+					cd->addPre( true, name, "USED-" + d.nodes[x]->name );
+				}
+				else cd->addPre( false, name, "AFREE" );
+
+				if ( !j ) cd->addEff( true, name, "AFREE" );
+				cd->addEff( false, name, "ACTIVE-" + d.nodes[x]->name, incvec( 0, size ) );
+				cd->addEff( false, name, "SKIPPED-" + d.nodes[x]->name );
+				cd->addEff( false, name, "USED-" + d.nodes[x]->name );
+			}
+
+			bool concurEffs = false;
+			for ( unsigned k = 0; k < d.nodes[x]->templates.size(); ++k ) 
+			{
+				int action = d.actions.index( d.nodes[x]->templates[k]->name );
+				std::string name = "DO-" + d.actions[action]->name;
+				unsigned size = d.actions[action]->params.size();
+				auto doit = cd->createAction( name, d.typeList(*d.actions[action]));
+
+				// old preconditions (shared with the original action)
+				doit->pre = shareConjuncts( d.actions[action]->pre );
+
+				// copy old effects
+				auto oldeff = std::dynamic_pointer_cast<And>( d.actions[action]->eff );
+				for ( unsigned l = 0; oldeff && l < oldeff->conds.size(); ++l )
+					concurEffs |= addEff( *cd, *doit, oldeff->conds[l] );
+				if ( !oldeff ) concurEffs |= addEff( *cd, *doit, d.actions[action]->eff );
+
+				// add new parameters
+				if ( !boundedCounters && ( cc.second.size() > 1 || d.nodes[x]->upper > 1 ) )
+					appendParams( *cd, *doit, cd->convertTypes( StringVec( 2, "AGENT-COUNT" ) ) );
+
+				// add new preconditions
+				if (cc.second.size() > 1 || d.nodes[x]->upper > 1 ) {
+					cd->addPre( false, name, "ACTIVE-" + d.nodes[x]->name, d.nodes[x]->templates[k]->params );
+					cd->addPre( true, name, "TAKEN", IntVec( 1, 0 ) );
+					if ( !boundedCounters ) {
+						cd->addPre( false, name, "COUNT-" + d.nodes[x]->name, incvec( size, size + 1 ) );
+						cd->addPre( false, name, "CONSEC", incvec( size, size + 2 ) );
+					}
+					else if ( d.nodes[x]->upper < 1000000 )
+						cd->addPre( true, name, counter( x, counterBound( x ) ) );
+				}
+				else cd->addPre( false, name, "AFREE" );
+
+				// add new effects
+				if (cc.second.size() > 1 || d.nodes[x]->upper > 1 ) {
+					cd->addEff( false, name, "TAKEN", IntVec( 1, 0 ) );
+					if ( !boundedCounters ) {
+						cd->addEff( true, name, "COUNT-" + d.nodes[x]->name, incvec( size, size + 1 ) );
+						cd->addEff( false, name, "COUNT-" + d.nodes[x]->name, incvec( size + 1, size + 2 ) );
+					}
+					// increment the counter, which saturates at its bound
+					// if the upper bound is infinite
+					for ( unsigned l = 0; boundedCounters && l < counterBound( x ); ++l ) {
+						auto inc = std::make_shared<And>();
+						inc->add( std::make_shared<Not>( std::make_shared<Ground>( cd->preds.get( counter( x, l ) ) ) ) );
+						inc->add( std::make_shared<Ground>( cd->preds.get( counter( x, l + 1 ) ) ) );
+						auto w = std::make_shared<When>();
+						w->pars = std::make_shared<Ground>( cd->preds.get( counter( x, l ) ) );
+						w->cond = inc;
+						std::dynamic_pointer_cast<And>( doit->eff )->add( w );
+					}
+				}
+
+				// an agent can only act once the agent before it in its orbit has acted
+				if ( symmetryBreaking ) {
+					auto f = std::make_shared<Forall>();
+					f->params = cd->convertTypes( StringVec( 1, "AGENT" ) );
+					unsigned var = doit->params.size();
+					auto o = std::make_shared<Or>();
+					IntVec prev( 1, var );
+					prev.push_back( 0 );
+					o->first = std::make_shared<Not>( std::make_shared<Ground>( cd->preds.get( "SYM-PREV" ), prev ) );
+					o->second = std::make_shared<Ground>( cd->preds.get( "ACTED" ), incvec( var, var + 1 ) );
+					f->cond = o;
+					std::dynamic_pointer_cast<And>( doit->pre )->add( f );
+					cd->addEff( false, name, "ACTED", IntVec( 1, 0 ) );
+				}
+			}
+
+			if (cc.second.size() > 1 || d.nodes[x]->upper > 1) 
+			{
+				std::string name = "END-" + d.nodes[x]->name;
+				unsigned size = d.nodes[x]->params.size();
+				auto end = cd->createAction( name, d.typeList(*d.nodes[x]));
+				if ( boundedCounters ) {
+					// the counter has a value between the bounds of the node
+					unsigned lower = std::min( d.nodes[x]->lower, counterBound( x ) );
+					std::shared_ptr<Condition> sat;
+					for ( unsigned l = lower; l <= counterBound( x ); ++l ) {
+						auto c = std::make_shared<Ground>( cd->preds.get( counter( x, l ) ) );
+						if ( sat ) {
+							auto o = std::make_shared<Or>();
+							o->first = sat;
+							o->second = c;
+							sat = o;
+						}
+						else sat = c;
+					}
+					std::dynamic_pointer_cast<And>( end->pre )->add( sat );
+				}
+				else {
+					appendParams( *cd, *end, cd->convertTypes( StringVec( 1, "AGENT-COUNT" ) ) );
+					cd->addPre( false, name, "COUNT-" + d.nodes[x]->name, incvec( size, size + 1 ) );
+					cd->addPre( false, name, "SAT-" + d.nodes[x]->name, incvec( size, size + 1 ) );
+				}
+				cd->addPre( false, name, "ACTIVE-" + d.nodes[x]->name, incvec( 0, size ) );
+
+				if ( boundedCounters ) {
+					for ( unsigned l = std::min( d.nodes[x]->lower, counterBound( x ) ); l <= counterBound( x ); ++l )
+						cd->addEff( true, name, counter( x, l ) );
+				}
+				else cd->addEff( true, name, "COUNT-" + d.nodes[x]->name, incvec( size, size + 1 ) );
+				if (cc.second.size() > 1 )
+					cd->addEff( false, name, "DONE-" + d.nodes[x]->name );
+				else {
+					cd->addEff( false, name, concurEffs ? "ATEMP" : "AFREE" );
+					cd->addEff( true, name, "ACTIVE-" + d.nodes[x]->name, incvec( 0, size ) );
+					auto f = std::make_shared<Forall>();
+					f->params = cd->convertTypes( StringVec( 1, "AGENT" ) );
+					unsigned var = end->params.size();
+					f->cond = std::make_shared<Not>(std::make_shared<Ground>( cd->preds.get( "TAKEN" ), incvec( var, var + 1 ) ) );
+					std::dynamic_pointer_cast<And>( end->eff )->add( f );
+				}
+			}
+
+			if (cc.second.size() > 1 && j + 1 == cc.second.size() ) 
+			{
+				std::string name = "FINISH-" + d.nodes[x]->name;
+				unsigned size = d.nodes[x]->params.size();
+				auto finish = cd->createAction(name, d.typeList(*d.nodes[x]));
+
+				cd->addOrPre( name, "DONE-" + d.nodes[x]->name, "SKIPPED-" + d.nodes[x]->name );
+				cd->addPre( false, name, "ACTIVE-" + d.nodes[x]->name, incvec( 0, size ) );
+
+				cd->addEff( false, name, "ATEMP" );
+				for (int k : cc.second)
+				{
+					cd->addEff( true, name, "DONE-" + d.nodes[k]->name );
+					cd->addEff( true, name, "SKIPPED-" + d.nodes[k]->name );
+					cd->addEff( true, name, "USED-" + d.nodes[k]->name );
+					cd->addEff( true, name, "ACTIVE-" + d.nodes[k]->name, incvec( 0, size ) );
+				}
+				auto f = std::make_shared<Forall>();
+				f->params = cd->convertTypes( StringVec( 1, "AGENT" ) );
+				f->cond = std::make_shared<Not>(std::make_shared<Ground>(cd->preds.get( "TAKEN" ), incvec( size, size + 1 )));
+				std::dynamic_pointer_cast<And>(finish->eff)->add(f);
+			}
+		}
+	}
+
+	for (unsigned int i : prob)
+	{
+		std::string name = "ADD-" + d.preds[i]->name;
+		size_t size = d.preds[i]->params.size();
+		cd->createAction( name, d.typeList( *d.preds[i] ) );
+		cd->addPre( false, name, "ATEMP" );
+		cd->addPre( false, name, "POS-" + d.preds[i]->name, incvec( 0, size ) );
+		cd->addPre( true, name, "NEG-" + d.preds[i]->name, incvec( 0, size ) );
+		cd->addEff( false, name, d.preds[i]->name, incvec( 0, size ) );
+		cd->addEff( true, name, "POS-" + d.preds[i]->name, incvec( 0, size ) );
+
+		name = "DELETE-" + d.preds[i]->name;
+		cd->createAction( name, d.typeList( *d.preds[i] ) );
+		cd->addPre( false, name, "ATEMP" );
+		cd->addPre( true, name, "POS-" + d.preds[i]->name, incvec( 0, size ) );
+		cd->addPre( false, name, "NEG-" + d.preds[i]->name, incvec( 0, size ) );
+		cd->addEff( true, name, d.preds[i]->name, incvec( 0, size ) );
+		cd->addEff( true, name, "NEG-" + d.preds[i]->name, incvec( 0, size ) );
+	}
+
+	auto freeit = cd->createAction( "FREE" );
+	cd->addPre( false, "FREE", "ATEMP" );
+	for (unsigned int i : prob)
+	{
+		auto f = std::make_shared<Forall>();
+		f->params = cd->convertTypes( d.typeList( *d.preds[i] ) );
+		auto a = std::make_shared<And>();
+		a->add(std::make_shared<Not>(std::make_shared<Ground>( cd->preds.get( "POS-" + d.preds[i]->name ), incvec( 0, f->params.size() ) ) ) );
+		a->add(std::make_shared<Not>(std::make_shared<Ground>( cd->preds.get( "NEG-" + d.preds[i]->name ), incvec( 0, f->params.size() ) ) ) );
+		f->cond = a;
+		std::dynamic_pointer_cast<And>(freeit->pre)->add(f);
+	}
+	cd->addEff( false, "FREE", "AFREE" );
+	cd->addEff( true, "FREE", "ATEMP" );
+
+	return cd;
+}
+
+std::shared_ptr< Instance > NetworkCompiler::compileInstance( Domain & cd, const Instance & ins ) const
+{
+	size_t nagents = d.types.get( "AGENT" )->noObjects();
+
+	auto cins = std::make_shared<Instance>(cd);
+	cins->name = ins.name;
+
+	// add objects
+	StringVec counts( 1, "ACOUNT-0" );
+	for ( unsigned i = 1; !boundedCounters && i <= nagents; ++i ) {
+		std::stringstream ss;
+		ss << "ACOUNT-" << i;
+		counts.push_back( ss.str() );
+		cins->addObject( counts[i], "AGENT-COUNT" );
+	}
+
+	// create initial state
+	FactCopier facts( d, cd );
+	for (auto& i : ins.init)
+		facts.copyInit( *i, *cins );
+	cins->addInit( "AFREE" );
+	for ( unsigned i = 1; !boundedCounters && i <= nagents; ++i ) {
+		StringVec pars( 1, counts[i - 1] );
+		pars.push_back( counts[i] );
+		cins->addInit( "CONSEC", pars );
+	}
+	if ( symmetryBreaking ) {
+		AgentSymmetry symmetry( d, ins );
+		for ( const auto & orbit : symmetry.orbits ) {
+			for ( unsigned i = 1; i < orbit.size(); ++i ) {
+				StringVec pars( 1, orbit[i - 1] );
+				pars.push_back( orbit[i] );
+				cins->addInit( "SYM-PREV", pars );
+			}
+		}
+	}
+	for ( unsigned i = 0; i < d.nodes.size(); ++i ) {
+		auto j = ccs.find( d.mf[i] );
+		if ( !boundedCounters && ( j->second.size() > 1 || d.nodes[i]->upper > 1 ) ) {
+			for ( unsigned j = d.nodes[i]->lower; j <= d.nodes[i]->upper && j <= nagents; ++j )
+				cins->addInit( "SAT-" + d.nodes[i]->name, StringVec( 1, counts[j] ) );
+		}
+	}
+
+	// create goal state
+	for (auto& i : ins.goal)
+		if ( !facts.copyGoal( *i, *cins ) )
+			cins->addGoal(i->name, d.objectList(*i) );
+	cins->addGoal( "AFREE" );
+
+	return cins;
+}
+
+} } // namespaces
@@ -1,6 +1,7 @@
 
 #include <multiagent/MultiagentDomain.h>
 #include <multiagent/NetworkNode.h>
+#include <multiagent/Scanner.h>
 
 namespace parser { namespace multiagent {
 
@@ -35,22 +36,22 @@ void NetworkNode::PDDLPrint( std::ostream & s, unsigned indent, const TokenStruc
 
 void NetworkNode::parse( Filereader & f, TokenStruct< std::string > & ts, Domain & d )
 {
-	f.next();
+	scanNext( f );
 	f.assert_token( ":PARAMETERS" );
 	f.assert_token( "(" );
 	TokenStruct< std::string > nstruct = f.parseTypedList( true, d.types );
 	params = d.convertTypes( nstruct.types );
 		
-	f.next();
+	scanNext( f );
 	f.assert_token( ":BOUNDS" );
 	f.assert_token( "(" );
-	std::string lo = f.getToken();
+	std::string lo = scanToken( f );
 	std::istringstream( lo ) >> lower;
-	f.next();
-	std::string hi = f.getToken();
+	scanNext( f );
+	std::string hi = scanToken( f );
 	if ( hi == "INF" ) upper = 1000000;
 	else std::istringstream( hi ) >> upper;
-	f.next();
+	scanNext( f );
 	f.assert_token( ")" );
 
 	f.assert_token( ":ACTIONS" );
@@ -59,21 +60,21 @@ void NetworkNode::parse( Filereader & f, TokenStruct< std::string > & ts, Domain
 	{
 		f.assert_token( "(" );
 		int action = d.actions.index( f.getToken( d.actions ) );
-		f.next();
+		scanNext( f );
 
 		auto c = std::make_shared<Lifted>( d.actions[action]->name );
 		c->params.resize( params.size() );
 		for ( unsigned i = 0; i < params.size(); ++i ) {
-			std::string index = f.getToken();
+			std::string index = scanToken( f );
 			std::istringstream( index ) >> c->params[i];
-			f.next();
+			scanNext( f );
 		}
 		templates.emplace_back( c );
 		f.assert_token( ")" );
 	}
 
 	++f.c;
-	f.next();
+	scanNext( f );
 	f.assert_token( ")" );
 }
 
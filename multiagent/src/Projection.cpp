@@ -0,0 +1,219 @@
+
+#include <multiagent/ConcurrencyDomain.h>
+#include <multiagent/LazyBodies.h>
+#include <multiagent/Projection.h>
+#include <multiagent/Parallel.h>
+
+#include <functional>
+
+namespace parser { namespace multiagent {
+
+using namespace pddl;
+
+// calls f on every literal of condition c
+static void forEachLiteral( const std::shared_ptr< Condition > & c, const std::function< void( const Ground & ) > & f )
+{
+	if ( !c ) return;
+	if ( auto g = std::dynamic_pointer_cast< Ground >( c ) ) f( *g );
+	else if ( auto n = std::dynamic_pointer_cast< Not >( c ) ) forEachLiteral( n->cond, f );
+	else if ( auto a = std::dynamic_pointer_cast< And >( c ) )
+		for ( const auto & child : a->conds ) forEachLiteral( child, f );
+	else if ( auto o = std::dynamic_pointer_cast< Oneof >( c ) )
+		for ( const auto & child : o->conds ) forEachLiteral( child, f );
+	else if ( auto o = std::dynamic_pointer_cast< Or >( c ) ) {
+		forEachLiteral( o->first, f );
+		forEachLiteral( o->second, f );
+	}
+	else if ( auto fa = std::dynamic_pointer_cast< Forall >( c ) ) forEachLiteral( fa->cond, f );
+	else if ( auto e = std::dynamic_pointer_cast< Exists >( c ) ) forEachLiteral( e->cond, f );
+	else if ( auto w = std::dynamic_pointer_cast< When >( c ) ) {
+		forEachLiteral( w->pars, f );
+		forEachLiteral( w->cond, f );
+	}
+}
+
+// whether name is a predicate or function of d; the concurrency predicates of
+// a ConcurrencyDomain are also in its preds, but they name actions
+static bool isFluent( const Domain & d, const std::string & name )
+{
+	if ( auto cd = dynamic_cast< const ConcurrencyDomain * >( &d ) )
+		if ( cd->cpreds.index( name ) >= 0 ) return false;
+	return d.preds.index( name ) >= 0 || d.funcs.index( name ) >= 0;
+}
+
+// Returns precondition c without the literals that are neither predicates nor
+// functions of d (the actions of other agents in concurrency constraints), or
+// nullptr if nothing remains. Unchanged subconditions are shared with c.
+static std::shared_ptr< Condition > stripForeign( const Domain & d, const std::shared_ptr< Condition > & c )
+{
+	if ( !c ) return c;
+	if ( std::dynamic_pointer_cast< Equals >( c ) ) return c;
+	if ( auto g = std::dynamic_pointer_cast< Ground >( c ) )
+		return isFluent( d, g->name ) ? c : nullptr;
+	if ( auto n = std::dynamic_pointer_cast< Not >( c ) ) return stripForeign( d, n->cond ) ? c : nullptr;
+
+	if ( auto a = std::dynamic_pointer_cast< And >( c ) ) {
+		auto na = std::make_shared< And >();
+		bool changed = false;
+		for ( const auto & child : a->conds ) {
+			auto s = stripForeign( d, child );
+			changed |= s != child;
+			if ( s ) na->add( s );
+		}
+		if ( !changed ) return c;
+		return na->conds.empty() ? nullptr : na;
+	}
+
+	if ( auto o = std::dynamic_pointer_cast< Or >( c ) ) {
+		auto first = stripForeign( d, o->first ), second = stripForeign( d, o->second );
+		if ( !first || !second ) return nullptr;
+		if ( first == o->first && second == o->second ) return c;
+		auto no = std::make_shared< Or >();
+		no->first = first;
+		no->second = second;
+		return no;
+	}
+
+	if ( auto f = std::dynamic_pointer_cast< Forall >( c ) ) {
+		auto body = stripForeign( d, f->cond );
+		if ( !body || body == f->cond ) return body ? c : nullptr;
+		auto nf = std::make_shared< Forall >();
+		nf->name = f->name;
+		nf->params = f->params;
+		nf->cond = body;
+		return nf;
+	}
+
+	if ( auto e = std::dynamic_pointer_cast< Exists >( c ) ) {
+		auto body = stripForeign( d, e->cond );
+		if ( !body || body == e->cond ) return body ? c : nullptr;
+		auto ne = std::make_shared< Exists >();
+		ne->name = e->name;
+		ne->params = e->params;
+		ne->cond = body;
+		return ne;
+	}
+
+	return c;
+}
+
+// domain with the actions acts of d, which only the agent in SELF can do
+static std::shared_ptr< Domain > projectDomain( const Domain & d, const std::vector< unsigned > & acts )
+{
+	auto pd = std::make_shared< Domain >();
+	pd->name = d.name;
+	pd->equality = d.equality;
+	pd->strips = d.strips;
+	pd->costs = d.costs;
+	pd->adl = d.adl;
+	pd->neg = d.neg;
+	pd->condeffects = d.condeffects;
+	pd->typed = d.typed;
+	pd->cons = d.cons;
+	pd->nondet = d.nondet;
+	pd->types = d.types;
+	pd->funcs = d.funcs;
+
+	std::set< unsigned > used;
+	auto use = [&]( const Ground & g ) {
+		int p = d.preds.index( g.name );
+		if ( p >= 0 && isFluent( d, g.name ) ) used.insert( p );
+	};
+	for ( unsigned i : acts ) {
+		forEachLiteral( d.actions[i]->pre, use );
+		forEachLiteral( d.actions[i]->eff, use );
+	}
+	for ( unsigned p : used ) pd->preds.insert( d.preds[p] );
+	pd->createPredicate( "SELF", StringVec( 1, d.types[0]->name ) );
+
+	for ( unsigned i : acts ) {
+		const auto & a = d.actions[i];
+		auto na = std::make_shared< Action >( a->name );
+		na->params = a->params;
+		auto pre = std::make_shared< And >();
+		pre->add( std::make_shared< Ground >( pd->preds.get( "SELF" ), IntVec( 1, 0 ) ) );
+		if ( auto s = stripForeign( d, a->pre ) ) pre->add( s );
+		na->pre = pre;
+		na->eff = a->eff;
+		pd->actions.insert( na );
+	}
+	return pd;
+}
+
+Projection::Projection( const Domain & dom, const Instance & ins, unsigned threads )
+	: d( dom )
+{
+	requireParsedConditions( d, "projecting it" );
+
+	// a predicate is private if all its literals take the agent at the same argument
+	std::vector< std::set< unsigned > > positions( d.preds.size() );
+	std::vector< bool > seen( d.preds.size(), false );
+	auto agentPositions = [&]( const Ground & g ) {
+		int p = d.preds.index( g.name );
+		if ( p < 0 || !isFluent( d, g.name ) ) return;
+		std::set< unsigned > s;
+		for ( unsigned k = 0; k < g.params.size(); ++k )
+			if ( g.params[k] == 0 ) s.insert( k );
+		if ( !seen[p] ) positions[p] = s;
+		else std::erase_if( positions[p], [&s]( unsigned k ) { return !s.contains( k ); } );
+		seen[p] = true;
+	};
+	for ( const auto & a : d.actions ) {
+		forEachLiteral( a->pre, agentPositions );
+		forEachLiteral( a->eff, agentPositions );
+	}
+	agentArg.assign( d.preds.size(), -1 );
+	for ( unsigned p = 0; p < d.preds.size(); ++p )
+		if ( seen[p] && positions[p].size() ) agentArg[p] = *positions[p].begin();
+
+	// actions that each agent can do
+	std::map< std::string, std::vector< unsigned > > acts;
+	for ( unsigned i = 0; i < d.actions.size(); ++i ) {
+		if ( d.actions[i]->params.empty() ) continue;
+		auto type = d.types[d.actions[i]->params[0]];
+		for ( unsigned j = 0; j < type->noObjects(); ++j ) {
+			std::string agent = type->object( j ).first;
+			if ( !acts.contains( agent ) ) {
+				tasks.push_back( AgentTask() );
+				tasks.back().agent = agent;
+			}
+			acts[agent].push_back( i );
+		}
+	}
+
+	// agents that can do the same actions share their domain
+	std::map< std::vector< unsigned >, std::shared_ptr< Domain > > domains;
+	for ( auto & t : tasks ) {
+		auto & pd = domains[acts[t.agent]];
+		if ( !pd ) pd = projectDomain( d, acts[t.agent] );
+		t.domain = pd;
+	}
+
+	// instances only read their (shared) domain, so they can be created concurrently
+	parallelFor( tasks.size(), threads, [&]( unsigned job, unsigned ) {
+		AgentTask & t = tasks[job];
+		auto keep = [&]( const Ground & g ) {
+			int p = d.preds.index( g.name );
+			if ( p < 0 || t.domain->preds.index( g.name ) < 0 ) return false;
+			return agentArg[p] < 0 || d.objectList( g )[agentArg[p]] == t.agent;
+		};
+
+		auto pi = std::make_shared< Instance >( *t.domain );
+		pi->name = ins.name + "-" + t.agent;
+		pi->metric = ins.metric;
+		pi->addInit( "SELF", StringVec( 1, t.agent ) );
+		for ( const auto & g : ins.init ) {
+			if ( auto gfd = std::dynamic_pointer_cast< GroundFunc< double > >( g ) )
+				pi->addInit( gfd->name, gfd->value, d.objectList( *gfd ) );
+			else if ( auto gfi = std::dynamic_pointer_cast< GroundFunc< int > >( g ) )
+				pi->addInit( gfi->name, gfi->value, d.objectList( *gfi ) );
+			else if ( keep( *g ) )
+				pi->addInit( g->name, d.objectList( *g ) );
+		}
+		for ( const auto & g : ins.goal )
+			if ( keep( *g ) ) pi->addGoal( g->name, d.objectList( *g ) );
+		t.instance = pi;
+	} );
+}
+
+} } // namespaces
@@ -0,0 +1,121 @@
+
+#include <multiagent/Scanner.h>
+
+#include <bit>
+
+#if defined( __AVX2__ )
+#include <immintrin.h>
+#elif defined( __SSE2__ )
+#include <emmintrin.h>
+#endif
+
+namespace parser { namespace multiagent {
+
+static inline bool blank( char c )
+{
+	return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+static inline bool delimiter( char c )
+{
+	return blank( c ) || c == '(' || c == ')' || c == ';';
+}
+
+#if defined( __AVX2__ )
+
+static inline __m256i blankMask( __m256i v )
+{
+	__m256i a = _mm256_or_si256( _mm256_cmpeq_epi8( v, _mm256_set1_epi8( ' ' ) ), _mm256_cmpeq_epi8( v, _mm256_set1_epi8( '\t' ) ) );
+	__m256i b = _mm256_or_si256( _mm256_cmpeq_epi8( v, _mm256_set1_epi8( '\r' ) ), _mm256_cmpeq_epi8( v, _mm256_set1_epi8( '\n' ) ) );
+	return _mm256_or_si256( a, b );
+}
+
+static inline __m256i delimiterMask( __m256i v )
+{
+	__m256i p = _mm256_or_si256( _mm256_cmpeq_epi8( v, _mm256_set1_epi8( '(' ) ), _mm256_cmpeq_epi8( v, _mm256_set1_epi8( ')' ) ) );
+	return _mm256_or_si256( _mm256_or_si256( blankMask( v ), p ), _mm256_cmpeq_epi8( v, _mm256_set1_epi8( ';' ) ) );
+}
+
+#elif defined( __SSE2__ )
+
+static inline __m128i blankMask( __m128i v )
+{
+	__m128i a = _mm_or_si128( _mm_cmpeq_epi8( v, _mm_set1_epi8( ' ' ) ), _mm_cmpeq_epi8( v, _mm_set1_epi8( '\t' ) ) );
+	__m128i b = _mm_or_si128( _mm_cmpeq_epi8( v, _mm_set1_epi8( '\r' ) ), _mm_cmpeq_epi8( v, _mm_set1_epi8( '\n' ) ) );
+	return _mm_or_si128( a, b );
+}
+
+static inline __m128i delimiterMask( __m128i v )
+{
+	__m128i p = _mm_or_si128( _mm_cmpeq_epi8( v, _mm_set1_epi8( '(' ) ), _mm_cmpeq_epi8( v, _mm_set1_epi8( ')' ) ) );
+	return _mm_or_si128( _mm_or_si128( blankMask( v ), p ), _mm_cmpeq_epi8( v, _mm_set1_epi8( ';' ) ) );
+}
+
+#endif
+
+size_t skipBlank( const std::string & s, size_t c )
+{
+	const char * p = s.data();
+	size_t n = s.size();
+#if defined( __AVX2__ )
+	for ( ; c + 32 <= n; c += 32 ) {
+		unsigned others = ~unsigned( _mm256_movemask_epi8( blankMask( _mm256_loadu_si256( ( const __m256i * )( p + c ) ) ) ) );
+		if ( others ) return c + std::countr_zero( others );
+	}
+#elif defined( __SSE2__ )
+	for ( ; c + 16 <= n; c += 16 ) {
+		unsigned others = ~unsigned( _mm_movemask_epi8( blankMask( _mm_loadu_si128( ( const __m128i * )( p + c ) ) ) ) ) & 0xFFFF;
+		if ( others ) return c + std::countr_zero( others );
+	}
+#endif
+	for ( ; c < n && blank( p[c] ); ++c );
+	return c;
+}
+
+size_t tokenEnd( const std::string & s, size_t c )
+{
+	const char * p = s.data();
+	size_t n = s.size();
+#if defined( __AVX2__ )
+	for ( ; c + 32 <= n; c += 32 ) {
+		unsigned ends = _mm256_movemask_epi8( delimiterMask( _mm256_loadu_si256( ( const __m256i * )( p + c ) ) ) );
+		if ( ends ) return c + std::countr_zero( ends );
+	}
+#elif defined( __SSE2__ )
+	for ( ; c + 16 <= n; c += 16 ) {
+		unsigned ends = _mm_movemask_epi8( delimiterMask( _mm_loadu_si128( ( const __m128i * )( p + c ) ) ) );
+		if ( ends ) return c + std::countr_zero( ends );
+	}
+#endif
+	for ( ; c < n && !delimiter( p[c] ); ++c );
+	return c;
+}
+
+const char * scannerInstructions()
+{
+#if defined( __AVX2__ )
+	return "AVX2";
+#elif defined( __SSE2__ )
+	return "SSE2";
+#else
+	return "scalar";
+#endif
+}
+
+void scanNext( pddl::Filereader & f )
+{
+	f.c = skipBlank( f.s, f.c );
+	if ( f.c == f.s.size() || f.s[f.c] == ';' ) f.next();
+}
+
+std::string scanToken( pddl::Filereader & f )
+{
+	size_t end = tokenEnd( f.s, f.c );
+	std::string token = f.s.substr( f.c, end - f.c );
+	for ( auto & ch : token )
+		if ( 'a' <= ch && ch <= 'z' ) ch -= 'a' - 'A';
+	f.c = end;
+	return token;
+}
+
+} } // namespaces
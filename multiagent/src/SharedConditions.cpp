@@ -0,0 +1,147 @@
+
+#include <multiagent/SharedConditions.h>
+
+#include <algorithm>
+#include <set>
+#include <typeinfo>
+
+namespace parser { namespace multiagent {
+
+using namespace pddl;
+
+template < typename T >
+static std::shared_ptr< Condition > shiftGround( const T & g, int m, unsigned n )
+{
+	auto s = std::make_shared< T >( g );
+	for ( int & p : s->params )
+		if ( p >= m ) p += n;
+	return s;
+}
+
+template < typename T >
+static std::shared_ptr< Condition > shiftQuantified( const Domain & d, const std::shared_ptr< T > & q, int m, unsigned n )
+{
+	auto body = shiftParams( d, q->cond, m, n );
+	if ( body == q->cond ) return q;
+	auto s = std::make_shared< T >();
+	s->name = q->name;
+	s->params = q->params;
+	s->cond = body;
+	return s;
+}
+
+std::shared_ptr< Condition > shiftParams( const Domain & d, const std::shared_ptr< Condition > & c, int m, unsigned n )
+{
+	if ( !c ) return c;
+
+	if ( auto g = std::dynamic_pointer_cast< Ground >( c ) ) {
+		if ( std::ranges::none_of( g->params, [m]( int p ) { return p >= m; } ) ) return c;
+		if ( typeid( *g ) == typeid( Ground ) ) return shiftGround( *g, m, n );
+		if ( typeid( *g ) == typeid( Equals ) ) return shiftGround( static_cast< const Equals & >( *g ), m, n );
+		// other atoms (such as concurrency grounds, with their constants)
+		// are copied by their own class below
+	}
+
+	if ( auto x = std::dynamic_pointer_cast< Not >( c ) ) {
+		auto cond = shiftParams( d, x->cond, m, n );
+		if ( cond == x->cond ) return c;
+		return std::make_shared< Not >( std::dynamic_pointer_cast< Ground >( cond ) );
+	}
+
+	if ( auto a = std::dynamic_pointer_cast< And >( c ) ) {
+		CondVec conds;
+		for ( const auto & i : a->conds ) conds.push_back( shiftParams( d, i, m, n ) );
+		if ( conds == a->conds ) return c;
+		auto s = std::make_shared< And >();
+		s->conds = conds;
+		return s;
+	}
+
+	if ( auto o = std::dynamic_pointer_cast< Oneof >( c ) ) {
+		CondVec conds;
+		for ( const auto & i : o->conds ) conds.push_back( shiftParams( d, i, m, n ) );
+		if ( conds == o->conds ) return c;
+		auto s = std::make_shared< Oneof >();
+		s->conds = conds;
+		return s;
+	}
+
+	if ( auto o = std::dynamic_pointer_cast< Or >( c ) ) {
+		auto first = shiftParams( d, o->first, m, n ), second = shiftParams( d, o->second, m, n );
+		if ( first == o->first && second == o->second ) return c;
+		auto s = std::make_shared< Or >();
+		s->first = first;
+		s->second = second;
+		return s;
+	}
+
+	if ( auto f = std::dynamic_pointer_cast< Forall >( c ) ) return shiftQuantified( d, f, m, n );
+	if ( auto e = std::dynamic_pointer_cast< Exists >( c ) ) return shiftQuantified( d, e, m, n );
+
+	if ( auto w = std::dynamic_pointer_cast< When >( c ) ) {
+		auto pars = shiftParams( d, w->pars, m, n ), cond = shiftParams( d, w->cond, m, n );
+		if ( pars == w->pars && cond == w->cond ) return c;
+		auto s = std::make_shared< When >();
+		s->pars = pars;
+		s->cond = cond;
+		return s;
+	}
+
+	auto s = c->copy( d );
+	s->addParams( m, n );
+	return s;
+}
+
+void appendParams( const Domain & d, Action & a, const IntVec & types )
+{
+	a.pre = shiftParams( d, a.pre, a.params.size(), types.size() );
+	a.eff = shiftParams( d, a.eff, a.params.size(), types.size() );
+	a.params.insert( a.params.end(), types.begin(), types.end() );
+}
+
+std::shared_ptr< And > shareConjuncts( const std::shared_ptr< Condition > & c )
+{
+	auto a = std::make_shared< And >();
+	if ( auto ca = std::dynamic_pointer_cast< And >( c ) ) a->conds = ca->conds;
+	else if ( c ) a->add( c );
+	return a;
+}
+
+static void addNodes( const std::shared_ptr< Condition > & c, std::set< const Condition * > & nodes )
+{
+	if ( !c || !nodes.insert( c.get() ).second ) return;
+
+	if ( auto x = std::dynamic_pointer_cast< Not >( c ) ) addNodes( x->cond, nodes );
+	else if ( auto a = std::dynamic_pointer_cast< And >( c ) )
+		for ( const auto & i : a->conds ) addNodes( i, nodes );
+	else if ( auto o = std::dynamic_pointer_cast< Oneof >( c ) )
+		for ( const auto & i : o->conds ) addNodes( i, nodes );
+	else if ( auto o = std::dynamic_pointer_cast< Or >( c ) ) {
+		addNodes( o->first, nodes );
+		addNodes( o->second, nodes );
+	}
+	else if ( auto f = std::dynamic_pointer_cast< Forall >( c ) ) addNodes( f->cond, nodes );
+	else if ( auto e = std::dynamic_pointer_cast< Exists >( c ) ) addNodes( e->cond, nodes );
+	else if ( auto w = std::dynamic_pointer_cast< When >( c ) ) {
+		addNodes( w->pars, nodes );
+		addNodes( w->cond, nodes );
+	}
+}
+
+std::pair< unsigned, unsigned > sharedNodes( const Domain & from, const Domain & to )
+{
+	std::set< const Condition * > source, target;
+	for ( const auto & a : from.actions ) {
+		addNodes( a->pre, source );
+		addNodes( a->eff, source );
+	}
+	for ( const auto & a : to.actions ) {
+		addNodes( a->pre, target );
+		addNodes( a->eff, target );
+	}
+
+	unsigned shared = std::ranges::count_if( target, [&]( const Condition * c ) { return source.contains( c ); } );
+	return std::make_pair( target.size(), shared );
+}
+
+} } // namespaces
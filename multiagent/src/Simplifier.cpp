@@ -0,0 +1,160 @@
+
+#include <multiagent/LazyBodies.h>
+#include <multiagent/Simplifier.h>
+
+#include <set>
+
+namespace parser { namespace multiagent {
+
+using namespace pddl;
+
+typedef std::pair< std::string, IntVec > Literal;
+
+static bool isEmpty( const std::shared_ptr< Condition > & c )
+{
+	auto a = std::dynamic_pointer_cast< And >( c );
+	return !c || ( a && a->conds.empty() );
+}
+
+// Returns the simplified condition, or nullptr if the condition is trivially
+// true (in a precondition) or has no effect (in an effect). Nodes are never
+// modified in place since the compilers may share them between actions.
+// If top is set, c is the precondition of the action and contradictory
+// literals make the action infeasible.
+static std::shared_ptr< Condition > simplifyCondition( const std::shared_ptr< Condition > & c, bool effect, bool top, bool & feasible )
+{
+	if ( !c ) return c;
+
+	if ( auto a = std::dynamic_pointer_cast< And >( c ) ) {
+		CondVec conds;
+		for ( const auto & child : a->conds ) {
+			auto s = simplifyCondition( child, effect, false, feasible );
+			if ( auto sa = std::dynamic_pointer_cast< And >( s ) )
+				conds.insert( conds.end(), sa->conds.begin(), sa->conds.end() );
+			else if ( s )
+				conds.push_back( s );
+		}
+
+		std::set< Literal > pos, neg;
+		for ( const auto & child : conds )
+			if ( auto g = std::dynamic_pointer_cast< Ground >( child ) )
+				pos.insert( Literal( g->name, g->params ) );
+
+		auto na = std::make_shared< And >();
+		std::set< Literal > added;
+		for ( const auto & child : conds ) {
+			auto g = std::dynamic_pointer_cast< Ground >( child );
+			auto n = std::dynamic_pointer_cast< Not >( child );
+			if ( g && !added.insert( Literal( g->name, g->params ) ).second )
+				continue;
+			if ( n && n->cond ) {
+				Literal l( n->cond->name, n->cond->params );
+				if ( !neg.insert( l ).second ) continue;
+				if ( pos.contains( l ) ) {
+					if ( effect ) continue; // the atom is added again by the same conjunction
+					if ( top ) feasible = false;
+				}
+			}
+			na->add( child );
+		}
+		return na;
+	}
+
+	if ( auto f = std::dynamic_pointer_cast< Forall >( c ) ) {
+		auto body = simplifyCondition( f->cond, effect, false, feasible );
+		if ( isEmpty( body ) ) return nullptr;
+		if ( f->params.empty() ) return body;
+		auto nf = std::make_shared< Forall >();
+		nf->name = f->name;
+		nf->params = f->params;
+		nf->cond = body;
+		return nf;
+	}
+
+	if ( auto e = std::dynamic_pointer_cast< Exists >( c ) ) {
+		auto body = simplifyCondition( e->cond, effect, false, feasible );
+		if ( e->params.empty() ) return body;
+		auto ne = std::make_shared< Exists >();
+		ne->name = e->name;
+		ne->params = e->params;
+		ne->cond = body ? body : std::make_shared< And >();
+		return ne;
+	}
+
+	if ( auto w = std::dynamic_pointer_cast< When >( c ) ) {
+		auto body = simplifyCondition( w->cond, true, false, feasible );
+		if ( isEmpty( body ) ) return nullptr;
+		auto pars = simplifyCondition( w->pars, false, false, feasible );
+		if ( isEmpty( pars ) ) return body;
+		auto nw = std::make_shared< When >();
+		nw->pars = pars;
+		nw->cond = body;
+		return nw;
+	}
+
+	if ( auto o = std::dynamic_pointer_cast< Or >( c ) ) {
+		auto first = simplifyCondition( o->first, effect, false, feasible );
+		auto second = simplifyCondition( o->second, effect, false, feasible );
+		if ( isEmpty( first ) || isEmpty( second ) ) return nullptr;
+		auto no = std::make_shared< Or >();
+		no->first = first;
+		no->second = second;
+		return no;
+	}
+
+	return c;
+}
+
+void Simplifier::simplify( Domain & cd )
+{
+	requireParsedConditions( cd, "simplifying it" );
+
+	TokenStruct< std::shared_ptr< Action > > actions;
+	for ( const auto & a : cd.actions ) {
+		sizeBefore += size( a->pre ) + size( a->eff );
+
+		bool feasible = true;
+		auto pre = simplifyCondition( a->pre, false, true, feasible );
+		if ( !feasible ) continue;
+
+		// keep the top-level conjunctions that the printer expects
+		if ( a->pre ) a->pre = pre ? pre : std::make_shared< And >();
+		if ( a->eff ) {
+			auto eff = simplifyCondition( a->eff, true, false, feasible );
+			a->eff = eff ? eff : std::make_shared< And >();
+		}
+
+		sizeAfter += size( a->pre ) + size( a->eff );
+		actions.insert( a );
+	}
+
+	actionsBefore += cd.actions.size();
+	actionsAfter += actions.size();
+	cd.actions = actions;
+}
+
+unsigned Simplifier::size( const std::shared_ptr< Condition > & c )
+{
+	if ( !c ) return 0;
+	if ( auto a = std::dynamic_pointer_cast< And >( c ) ) {
+		unsigned s = 1;
+		for ( const auto & child : a->conds ) s += size( child );
+		return s;
+	}
+	if ( auto n = std::dynamic_pointer_cast< Not >( c ) ) return 1 + size( n->cond );
+	if ( auto f = std::dynamic_pointer_cast< Forall >( c ) ) return 1 + size( f->cond );
+	if ( auto e = std::dynamic_pointer_cast< Exists >( c ) ) return 1 + size( e->cond );
+	if ( auto w = std::dynamic_pointer_cast< When >( c ) ) return 1 + size( w->pars ) + size( w->cond );
+	if ( auto o = std::dynamic_pointer_cast< Or >( c ) ) return 1 + size( o->first ) + size( o->second );
+	return 1;
+}
+
+void Simplifier::report( std::ostream & os ) const
+{
+	os << "actions: " << actionsBefore << " -> " << actionsAfter;
+	os << ", condition nodes: " << sizeBefore << " -> " << sizeAfter;
+	if ( sizeBefore ) os << " (-" << 100.0 * ( sizeBefore - sizeAfter ) / sizeBefore << "%)";
+	os << "\n";
+}
+
+} } // namespaces
@@ -0,0 +1,92 @@
+
+#include <multiagent/StaticPredicates.h>
+
+namespace parser { namespace multiagent {
+
+using namespace pddl;
+
+static void changedPredicates( const std::shared_ptr< Condition > & eff, std::set< std::string > & changed )
+{
+	if ( auto a = std::dynamic_pointer_cast< And >( eff ) ) {
+		for ( const auto & c : a->conds ) changedPredicates( c, changed );
+	}
+	else if ( auto n = std::dynamic_pointer_cast< Not >( eff ) ) {
+		if ( n->cond ) changed.insert( n->cond->name );
+	}
+	else if ( auto g = std::dynamic_pointer_cast< Ground >( eff ) ) {
+		changed.insert( g->name );
+	}
+	else if ( auto f = std::dynamic_pointer_cast< Forall >( eff ) ) {
+		changedPredicates( f->cond, changed );
+	}
+	else if ( auto w = std::dynamic_pointer_cast< When >( eff ) ) {
+		changedPredicates( w->cond, changed );
+	}
+	else if ( auto o = std::dynamic_pointer_cast< Oneof >( eff ) ) {
+		for ( const auto & c : o->conds ) changedPredicates( c, changed );
+	}
+}
+
+std::set< unsigned > staticPredicates( const Domain & d )
+{
+	std::set< std::string > changed;
+	for ( const auto & a : d.actions )
+		changedPredicates( a->eff, changed );
+
+	std::set< unsigned > result;
+	for ( unsigned i = 0; i < d.preds.size(); ++i )
+		if ( !changed.contains( d.preds[i]->name ) )
+			result.insert( i );
+	return result;
+}
+
+static void changedPredicates( const FrozenDomain & d, int node, std::set< unsigned > & changed )
+{
+	if ( node < 0 ) return;
+	const FrozenDomain::Node & n = d.nodes[node];
+	auto children = FrozenDomain::part( d.children, n.children );
+	switch ( n.kind ) {
+		case FrozenDomain::GROUND:
+			if ( n.symbol >= 0 ) changed.insert( n.symbol );
+			break;
+		case FrozenDomain::WHEN:
+			// only the effect of a conditional effect changes predicates
+			if ( children[1] != FrozenDomain::none ) changedPredicates( d, children[1], changed );
+			break;
+		case FrozenDomain::NOT:
+		case FrozenDomain::AND:
+		case FrozenDomain::FORALL:
+		case FrozenDomain::ONEOF:
+			for ( unsigned c : children )
+				if ( c != FrozenDomain::none ) changedPredicates( d, c, changed );
+			break;
+		default:
+			break;
+	}
+}
+
+std::set< unsigned > staticPredicates( const FrozenDomain & d )
+{
+	std::set< unsigned > changed;
+	for ( const auto & a : d.actions )
+		changedPredicates( d, a.eff, changed );
+
+	std::set< unsigned > result;
+	for ( unsigned i = 0; i < d.preds.size(); ++i )
+		if ( !changed.contains( i ) )
+			result.insert( i );
+	return result;
+}
+
+CondVec preconditionLiterals( const Action & a )
+{
+	CondVec result;
+	auto conds = CondVec( 1, a.pre );
+	if ( auto pre = std::dynamic_pointer_cast< And >( a.pre ) ) conds = pre->conds;
+	for ( const auto & c : conds )
+		if ( std::dynamic_pointer_cast< Ground >( c ) || std::dynamic_pointer_cast< Not >( c ) )
+			result.push_back( c );
+	return result;
+}
+
+} } // namespaces
@@ -0,0 +1,182 @@
+
+#include <multiagent/Statistics.h>
+#include <multiagent/StaticPredicates.h>
+
+namespace parser { namespace multiagent {
+
+using namespace pddl;
+
+DomainStatistics::DomainStatistics( const Domain & dom, const Instance & ins )
+	: d( dom ), groundPredicates( 0 ), fd( freeze( dom, true ) ), hierarchy( dom )
+{
+	for ( unsigned t = 0; t < hierarchy.types(); ++t )
+		objects.push_back( std::make_pair( fd->types[t].name, hierarchy.objects( t ).size() ) );
+
+	// concurrency predicates have no effects, but they are not facts
+	for ( unsigned p : staticPredicates( *fd ) )
+		if ( !fd->preds[p].concurrency )
+			facts[p] = 0;
+	for ( const auto & g : ins.init ) {
+		auto it = facts.find( fd->predIndex( g->name ) );
+		if ( it != facts.end() ) ++it->second;
+	}
+
+	for ( const auto & p : fd->preds ) groundPredicates += typeProduct( FrozenDomain::part( fd->params, p.params ) );
+
+	for ( unsigned i = 0; i < fd->actions.size(); ++i ) {
+		Schema s;
+		s.name = fd->actions[i].signature.name;
+		s.arity = fd->actions[i].signature.params.size;
+		s.size = actionSize( i );
+		actions.push_back( s );
+	}
+
+	for ( const auto & n : fd->network ) {
+		Schema s;
+		s.name = n.signature.name;
+		s.arity = n.signature.params.size;
+		s.size.naive = s.size.estimate = typeProduct( FrozenDomain::part( fd->params, n.signature.params ) );
+		nodes.push_back( s );
+	}
+}
+
+unsigned DomainStatistics::agents() const
+{
+	int t = fd->typeIndex( "AGENT" );
+	return t < 0 ? 0 : objects[t].second;
+}
+
+double DomainStatistics::typeProduct( std::span< const int > types ) const
+{
+	double n = 1;
+	for ( int t : types ) n *= objects[t].second;
+	return n;
+}
+
+GroundingSize DomainStatistics::actionSize( int a ) const
+{
+	const FrozenDomain::Action & action = fd->actions[a];
+	auto params = FrozenDomain::part( fd->params, action.signature.params );
+
+	GroundingSize s;
+	s.naive = s.estimate = typeProduct( params );
+	if ( action.pre < 0 ) return s;
+
+	// each static literal in the top-level conjunction of the precondition
+	// keeps the fraction of the tuples of its variables that are initial
+	// facts (constants are not told apart)
+	unsigned pre = action.pre;
+	auto literals = std::span< const unsigned >( &pre, 1 );
+	if ( fd->nodes[pre].kind == FrozenDomain::AND ) literals = FrozenDomain::part( fd->children, fd->nodes[pre].children );
+	for ( unsigned c : literals ) {
+		const FrozenDomain::Node & g = fd->nodes[c];
+		if ( g.kind != FrozenDomain::GROUND ) continue;
+		auto it = facts.find( g.symbol );
+		if ( it == facts.end() ) continue;
+
+		IntVec vars;
+		for ( int k : FrozenDomain::part( fd->args, g.args ) )
+			if ( k >= 0 && std::find( vars.begin(), vars.end(), k ) == vars.end() ) vars.push_back( k );
+		double tuples = 1;
+		for ( int k : vars ) tuples *= objects[params[k]].second;
+		if ( tuples > 0 ) s.estimate *= std::min( 1.0, it->second / tuples );
+	}
+	return s;
+}
+
+GroundingSize DomainStatistics::groundActions() const
+{
+	GroundingSize s;
+	for ( const auto & a : actions ) s += a.size;
+	return s;
+}
+
+GroundingSize DomainStatistics::compiledSize( const NetworkCompiler & compiler ) const
+{
+	unsigned n = agents();
+
+	GroundingSize s;
+	for ( const auto & cc : compiler.ccs ) {
+		for ( unsigned j = 0; j < cc.second.size(); ++j ) {
+			unsigned x = cc.second[j];
+			const auto & node = fd->network[x];
+			bool counted = cc.second.size() > 1 || node.upper > 1;
+			double size = typeProduct( FrozenDomain::part( fd->params, node.signature.params ) );
+
+			// START-, SKIP-, END- and FINISH- actions have the parameters of
+			// the node; with AGENT-COUNT objects END- also has a count, and
+			// the initial SAT- facts only hold for the satisfying counts
+			if ( counted ) {
+				double sat = node.lower > std::min( node.upper, n ) ? 0 : std::min( node.upper, n ) - node.lower + 1;
+				s.naive += size * ( compiler.boundedCounters ? 2 : n + 2 );
+				s.estimate += size * ( compiler.boundedCounters ? 2 : 1 + sat );
+			}
+			if ( cc.second.size() > 1 ) {
+				double k = j + 1 == cc.second.size() ? 2 : 1;
+				s.naive += k * size;
+				s.estimate += k * size;
+			}
+
+			// DO- actions have two AGENT-COUNT parameters, of which only the
+			// n consecutive pairs are in the initial CONSEC facts
+			for ( const auto & t : FrozenDomain::part( fd->templates, node.templates ) ) {
+				auto a = actionSize( t.action );
+				bool counts = counted && !compiler.boundedCounters;
+				s.naive += a.naive * ( counts ? double( n + 1 ) * ( n + 1 ) : 1 );
+				s.estimate += a.estimate * ( counts ? n : 1 );
+			}
+		}
+	}
+
+	// ADD- and DELETE- for every problematic fluent, and FREE
+	for ( unsigned p : compiler.prob ) {
+		double size = 2 * typeProduct( FrozenDomain::part( fd->params, fd->preds[p].params ) );
+		s += GroundingSize{ size, size };
+	}
+	s += GroundingSize{ 1, 1 };
+	return s;
+}
+
+GroundingSize DomainStatistics::compiledSize( const ConcurrencyCompiler & compiler ) const
+{
+	double n = agents(), m = std::max( 0, compiler.maxJointActionSize );
+
+	// SELECT- and END- actions get two AGENT-ORDER-COUNT parameters (n + 1
+	// objects) with the agent order and two ATOMIC-ACTION-COUNT parameters
+	// (m + 1 objects) with a joint action limit; the static AGENT-ORDER facts
+	// fix the counts of SELECT- and the n (m) consecutive pairs those of END-
+	double order = compiler.useAgentOrder ? ( n + 1 ) * ( n + 1 ) : 1;
+	double joint = compiler.maxJointActionSize > 0 ? ( m + 1 ) * ( m + 1 ) : 1;
+	double selectOrder = 1, endOrder = compiler.useAgentOrder ? n : 1;
+	double pairs = compiler.maxJointActionSize > 0 ? m : 1;
+
+	// START, APPLY, RESET and FINISH
+	GroundingSize s{ 4, 4 };
+	for ( unsigned i = 0; i < fd->actions.size(); ++i ) {
+		auto size = actionSize( i );
+		s.naive += size.naive * ( 2 * order * joint + 1 );
+		s.estimate += size.estimate * ( ( selectOrder + endOrder ) * pairs + 1 );
+	}
+	return s;
+}
+
+void DomainStatistics::report( std::ostream & os ) const
+{
+	os << "types:\n";
+	for ( const auto & [name, n] : objects )
+		os << "  " << name << " " << n << "\n";
+
+	auto schemas = [&os]( const std::string & title, const std::vector< Schema > & v ) {
+		os << title << ":\n";
+		for ( const auto & s : v )
+			os << "  " << s.name << "/" << s.arity << " " << s.size.naive << " ground, " << s.size.estimate << " estimated\n";
+	};
+	schemas( "actions", actions );
+	if ( nodes.size() ) schemas( "nodes", nodes );
+
+	auto total = groundActions();
+	os << "ground predicates: " << groundPredicates << "\n";
+	os << "ground actions: " << total.naive << ", " << total.estimate << " estimated\n";
+}
+
+} } // namespaces
@@ -0,0 +1,119 @@
+
+#include <multiagent/Symmetry.h>
+
+#include <algorithm>
+#include <sstream>
+
+namespace parser { namespace multiagent {
+
+using namespace pddl;
+
+// fact of the initial state or the goal: goal flag, predicate or function,
+// objects and value (for functions)
+typedef std::tuple< bool, std::string, StringVec, std::string > Fact;
+
+static Fact makeFact( const Domain & d, const Ground & g, bool goal )
+{
+	std::ostringstream value;
+	if ( auto gfd = dynamic_cast< const GroundFunc< double > * >( &g ) ) value << gfd->value;
+	else if ( auto gfi = dynamic_cast< const GroundFunc< int > * >( &g ) ) value << gfi->value;
+	return Fact( goal, g.name, d.objectList( g ), value.str() );
+}
+
+static Fact rename( Fact f, const std::map< std::string, std::string > & m )
+{
+	for ( auto & o : std::get< 2 >( f ) ) {
+		auto it = m.find( o );
+		if ( it != m.end() ) o = it->second;
+	}
+	return f;
+}
+
+AgentSymmetry::AgentSymmetry( const Domain & d, const Instance & ins )
+{
+	if ( d.types.index( "AGENT" ) < 0 ) return;
+
+	std::set< std::string > agents, constants;
+	auto agentType = d.types.get( "AGENT" );
+	for ( unsigned i = 0; i < agentType->noObjects(); ++i )
+		agents.insert( agentType->object( i ).first );
+
+	// direct type of each agent; constants are never interchangeable
+	std::map< std::string, std::string > types;
+	for ( const auto & t : d.types ) {
+		for ( unsigned j = 0; j < t->constants.size(); ++j ) constants.insert( t->constants[j] );
+		for ( unsigned j = 0; j < t->objects.size(); ++j ) types.insert( std::make_pair( t->objects[j], t->name ) );
+	}
+
+	std::set< Fact > facts;
+	std::map< std::string, std::vector< Fact > > factsOf; // facts that mention each agent
+	auto addFact = [&]( const Ground & g, bool goal ) {
+		Fact f = makeFact( d, g, goal );
+		if ( !facts.insert( f ).second ) return;
+		std::set< std::string > mentioned;
+		for ( const auto & o : std::get< 2 >( f ) )
+			if ( agents.contains( o ) && mentioned.insert( o ).second ) factsOf[o].push_back( f );
+	};
+	for ( const auto & g : ins.init ) addFact( *g, false );
+	for ( const auto & g : ins.goal ) addFact( *g, true );
+
+	// agents can only be exchanged if they have the same type and the same
+	// facts once the agent is replaced by "?" and the other agents by "*"
+	std::map< std::pair< std::string, std::vector< Fact > >, StringVec > candidates;
+	for ( const auto & a : agents ) {
+		if ( constants.contains( a ) ) continue;
+		std::vector< Fact > fingerprint;
+		for ( auto f : factsOf[a] ) {
+			for ( auto & o : std::get< 2 >( f ) )
+				if ( o == a ) o = "?";
+				else if ( agents.contains( o ) ) o = "*";
+			fingerprint.push_back( f );
+		}
+		std::sort( fingerprint.begin(), fingerprint.end() );
+		candidates[std::make_pair( types[a], fingerprint )].push_back( a );
+	}
+
+	// the exchange of a and b is a symmetry if it maps every fact that
+	// mentions them onto a fact
+	auto exchangeable = [&]( const std::string & a, const std::string & b ) {
+		std::map< std::string, std::string > m = { { a, b }, { b, a } };
+		for ( const auto & x : { a, b } )
+			for ( const auto & f : factsOf[x] )
+				if ( !facts.contains( rename( f, m ) ) ) return false;
+		return true;
+	};
+
+	// exchanges with the first agent of an orbit generate all its permutations
+	for ( const auto & c : candidates ) {
+		std::vector< StringVec > found;
+		for ( const auto & a : c.second ) {
+			auto it = std::find_if( found.begin(), found.end(), [&]( const StringVec & o ) { return exchangeable( o[0], a ); } );
+			if ( it == found.end() ) found.push_back( StringVec( 1, a ) );
+			else it->push_back( a );
+		}
+		for ( const auto & o : found )
+			if ( o.size() > 1 ) orbits.push_back( o );
+	}
+	std::sort( orbits.begin(), orbits.end() );
+}
+
+double AgentSymmetry::permutations() const
+{
+	double p = 1;
+	for ( const auto & o : orbits )
+		for ( unsigned i = 2; i <= o.size(); ++i ) p *= i;
+	return p;
+}
+
+void AgentSymmetry::report( std::ostream & os ) const
+{
+	os << orbits.size() << " orbits";
+	for ( const auto & o : orbits ) {
+		os << " {";
+		for ( unsigned i = 0; i < o.size(); ++i ) os << ( i ? " " : "" ) << o[i];
+		os << "}";
+	}
+	os << ", " << permutations() << " symmetric agent permutations\n";
+}
+
+} } // namespaces
@@ -0,0 +1,121 @@
+
+#include <multiagent/TypeHierarchy.h>
+
+namespace parser { namespace multiagent {
+
+using namespace pddl;
+
+static int supertypeOf( const Domain & d, unsigned t )
+{
+	auto super = d.types[t]->supertype.lock();
+	return super ? d.types.index( super->name ) : -1;
+}
+
+// hash of the names of the objects and then the constants declared in t
+static size_t fingerprint( const Type & t )
+{
+	size_t h = t.objects.size();
+	auto add = [&h]( const std::string & s ) { h = h * 1000003 ^ std::hash< std::string >()( s ); };
+	for ( unsigned j = 0; j < t.objects.size(); ++j ) add( t.objects[j] );
+	h = h * 1000003 ^ t.constants.size();
+	for ( unsigned j = 0; j < t.constants.size(); ++j ) add( t.constants[j] );
+	return h;
+}
+
+TypeHierarchy::TypeHierarchy( const Domain & dom )
+	: d( dom ), words( 0 )
+{
+	build();
+}
+
+bool TypeHierarchy::current() const
+{
+	if ( supertypes.size() != d.types.size() ) return false;
+	for ( unsigned t = 0; t < d.types.size(); ++t )
+		if ( supertypes[t] != supertypeOf( d, t ) || fingerprints[t] != fingerprint( *d.types[t] ) )
+			return false;
+	return true;
+}
+
+bool TypeHierarchy::update()
+{
+	if ( current() ) return false;
+	build();
+	return true;
+}
+
+void TypeHierarchy::build()
+{
+	unsigned n = d.types.size();
+	supertypes.resize( n );
+	fingerprints.resize( n );
+	for ( unsigned t = 0; t < n; ++t ) {
+		supertypes[t] = supertypeOf( d, t );
+		fingerprints[t] = fingerprint( *d.types[t] );
+	}
+
+	// each type and its supertypes (at most n of them, in case of a cycle)
+	words = ( n + 63 ) / 64;
+	closure.assign( n * words, 0 );
+	for ( unsigned t = 0; t < n; ++t ) {
+		int u = t;
+		for ( unsigned k = 0; u >= 0 && k < n; u = supertypes[u], ++k )
+			closure[t * words + u / 64] |= 1ull << ( u % 64 );
+	}
+
+	names.clear();
+	constantNames.clear();
+	objectTypes.clear();
+	constantTypes.clear();
+	objectRanges.assign( n, std::make_pair( 0, 0 ) );
+	constantRanges.assign( n, std::make_pair( 0, 0 ) );
+	std::vector< UnsignedVec > subtypes( n );
+	for ( unsigned t = 0; t < n; ++t )
+		if ( supertypes[t] >= 0 && supertypes[t] != (int)t ) subtypes[supertypes[t]].push_back( t );
+	for ( unsigned t = 0; t < n; ++t )
+		if ( supertypes[t] < 0 ) visit( t, subtypes );
+}
+
+// appends the objects and constants of t and then those of its subtypes
+void TypeHierarchy::visit( unsigned t, const std::vector< UnsignedVec > & subtypes )
+{
+	const Type & type = *d.types[t];
+	objectRanges[t].first = names.size();
+	constantRanges[t].first = constantNames.size();
+	for ( unsigned j = 0; j < type.objects.size(); ++j )
+		if ( objectTypes.insert( std::make_pair( type.objects[j], t ) ).second )
+			names.push_back( type.objects[j] );
+	for ( unsigned j = 0; j < type.constants.size(); ++j )
+		if ( constantTypes.insert( std::make_pair( type.constants[j], t ) ).second )
+			constantNames.push_back( type.constants[j] );
+
+	for ( unsigned u : subtypes[t] ) visit( u, subtypes );
+
+	objectRanges[t].second = names.size();
+	constantRanges[t].second = constantNames.size();
+}
+
+static int find( const std::map< std::string, int > & m, const std::string & s )
+{
+	auto it = m.find( s );
+	return it == m.end() ? -1 : it->second;
+}
+
+int TypeHierarchy::objectType( const std::string & s ) const
+{
+	return find( objectTypes, s );
+}
+
+int TypeHierarchy::constantType( const std::string & s ) const
+{
+	return find( constantTypes, s );
+}
+
+bool TypeHierarchy::isA( const std::string & s, unsigned t ) const
+{
+	int u = objectType( s );
+	if ( u < 0 ) u = constantType( s );
+	return u >= 0 && subtype( u, t );
+}
+
+} } // namespaces
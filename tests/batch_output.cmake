@@ -0,0 +1,45 @@
+# Compiles the same problems with batch_compile and one at a time with
+# serialize (concurrency) or serialize_cn (network), and fails if a domain or
+# a problem written by batch_compile differs from the output of serialize.
+# Run with cmake -DBATCH=<batch_compile> -DSERIALIZE=<serialize>
+# -DSERIALIZE_CN=<serialize_cn> -P batch_output.cmake in the test directory.
+
+set(problems
+    domains/maze/problems/maze5_4_1.pddl
+    domains/maze/problems/maze5_4_2.pddl
+    domains/maze/problems/maze5_4_3.pddl)
+
+function(check_batch compiler domain serialize)
+    set(dir batch_${compiler})
+    file(REMOVE_RECURSE ${dir})
+
+    # two threads for three problems, so a worker reuses its domain
+    execute_process(COMMAND ${BATCH} -t 2 -d ${dir} ${compiler} ${domain} ${problems}
+                    RESULT_VARIABLE rc OUTPUT_QUIET)
+    if(NOT rc EQUAL 0)
+        message(FATAL_ERROR "batch_compile ${compiler} failed: ${rc}")
+    endif()
+
+    foreach(problem ${problems})
+        get_filename_component(stem ${problem} NAME_WE)
+        execute_process(COMMAND ${serialize} ${domain} ${problem}
+                        OUTPUT_FILE ${dir}/${stem}.domain ERROR_FILE ${dir}/${stem}.problem
+                        RESULT_VARIABLE rc)
+        if(NOT rc EQUAL 0)
+            message(FATAL_ERROR "${serialize} ${domain} ${problem} failed: ${rc}")
+        endif()
+
+        foreach(pair "domain.pddl;${stem}.domain" "${stem}.pddl;${stem}.problem")
+            list(GET pair 0 batch)
+            list(GET pair 1 single)
+            execute_process(COMMAND ${CMAKE_COMMAND} -E compare_files ${dir}/${batch} ${dir}/${single}
+                            RESULT_VARIABLE rc)
+            if(NOT rc EQUAL 0)
+                message(FATAL_ERROR "${compiler}: ${dir}/${batch} differs from the output of ${serialize} for ${problem}")
+            endif()
+        endforeach()
+    endforeach()
+endfunction()
+
+check_batch(network domains/maze/domain/maze_dom_cn.pddl ${SERIALIZE_CN})
+check_batch(concurrency domains/maze/domain/maze_dom_cal.pddl ${SERIALIZE})
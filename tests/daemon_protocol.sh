@@ -0,0 +1,63 @@
+#!/bin/sh
+# Drives compile_daemon through stdin and through a Unix domain socket and
+# checks its answers against the output of serialize_cn.
+# Usage: daemon_protocol.sh <compile_daemon> <serialize_cn>, in the test directory.
+set -e
+daemon=$1
+serialize=$2
+dom=domains/maze/domain/maze_dom_cn.pddl
+ins=domains/maze/problems/maze5_4_1.pddl
+dir=daemon_test
+rm -rf $dir
+mkdir -p $dir
+"$serialize" $dom $ins > $dir/domain.pddl 2> $dir/problem.pddl
+
+# answer with status $1 and the contents of file $2 as payload
+expect() {
+    printf '%s %s\n' "$1" "$(wc -c < "$2" | tr -d ' ')"
+    cat "$2"
+}
+
+# stdin: answers are "OK <bytes>" or "ERROR <bytes>" followed by the payload
+: > $dir/empty
+{ expect OK $dir/domain.pddl; expect OK $dir/problem.pddl; expect OK $dir/empty; } > $dir/expected
+printf 'domain network %s\ncompile network %s %s\nquit\n' $dom $dom $ins | "$daemon" > $dir/answers 2> /dev/null
+cmp $dir/expected $dir/answers
+
+# a problem that fails to parse is an error, and the daemon goes on
+printf 'validate network %s missing.pddl\nbad request\nquit\n' $dom | "$daemon" > $dir/errors 2> /dev/null
+test "$(grep -c '^ERROR ' $dir/errors)" -eq 2
+tail -n 1 $dir/errors | grep -q '^OK 0$'
+
+# socket: the client prints the payload of the answer
+sock=$dir/daemon.sock
+"$daemon" -n 2 -s $sock 2> /dev/null &
+pid=$!
+trap 'kill $pid 2> /dev/null || true' EXIT
+for i in 1 2 3 4 5 6 7 8 9 10; do
+    test -S $sock && break
+    sleep 1
+done
+
+# more requests than -n at the same time; each client reads exactly its
+# answer, so it does not wait for the processes serving the others
+clients=""
+for i in 1 2 3 4; do
+    "$daemon" -c $sock compile network $dom $ins > $dir/socket$i.pddl &
+    clients="$clients $!"
+done
+for client in $clients; do
+    wait $client
+done
+for i in 1 2 3 4; do
+    cmp $dir/problem.pddl $dir/socket$i.pddl
+done
+"$daemon" -c $sock domain network $dom > $dir/socket_domain.pddl
+cmp $dir/domain.pddl $dir/socket_domain.pddl
+if "$daemon" -c $sock validate network $dom missing.pddl > /dev/null 2>&1; then
+    echo "validate of a missing problem succeeded"
+    exit 1
+fi
+
+"$daemon" -c $sock quit
+wait $pid
@@ -0,0 +1,502 @@
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <new>
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+#include <parser/Instance.h>
+#include <multiagent/ConcurrencyCompiler.h>
+#include <multiagent/FactStore.h>
+#include <multiagent/NetworkCompiler.h>
+#include <multiagent/Scanner.h>
+#include <multiagent/SharedConditions.h>
+
+// Families of growing synthetic domains and problems. For every family the
+// parse and compile phases are timed and their heap allocations counted at
+// several sizes, and the growth exponents k of time ~ size^k and allocations ~
+// size^k are fitted by least squares on the log-log samples and printed. The
+// test fails when the allocations of some phase grow faster than the
+// configured bound: they do not depend on the load of the machine, and a phase
+// that does work per pair of elements almost always allocates per pair too.
+// Times are also checked, against the bound plus a margin for noise, or
+// against the bound itself if the environment variable SCALING_TIMING_CHECKS
+// is set (and not 0).
+
+#ifndef SCALING_MAX_EXPONENT
+#define SCALING_MAX_EXPONENT 1.5
+#endif
+
+// time and heap allocations of a phase
+struct Cost
+{
+    double seconds = 0;
+    unsigned long allocations = 0;
+};
+
+typedef std::map< std::string, Cost > PhaseCosts;
+typedef std::function< PhaseCosts( unsigned ) > Pipeline;
+
+static double maxExponent()
+{
+    if (const char* s = std::getenv("SCALING_MAX_EXPONENT"))
+        return std::atof(s);
+    return SCALING_MAX_EXPONENT;
+}
+
+// bound of the growth exponents fitted on times, which are noisy unless the
+// machine is idle (as SCALING_TIMING_CHECKS tells)
+static double timingExponent()
+{
+    const char* s = std::getenv("SCALING_TIMING_CHECKS");
+    bool strict = s && *s && std::string(s) != "0";
+    return strict ? maxExponent() : maxExponent() + 0.5;
+}
+
+template<typename F>
+static double measure(F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// heap allocations made by this program, counted by the global operator new
+static std::atomic<unsigned long> allocations(0);
+
+void* operator new(std::size_t n)
+{
+    ++allocations;
+    if (void* p = std::malloc(n ? n : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+template<typename F>
+static unsigned long countAllocations(F f)
+{
+    unsigned long before = allocations;
+    f();
+    return allocations - before;
+}
+
+// time and allocations of f
+template<typename F>
+static Cost measureCost(F f)
+{
+    Cost c;
+    c.seconds = measure([&] { c.allocations = countAllocations(f); });
+    return c;
+}
+
+// least-squares slope of log(cost) against log(size)
+static double fitExponent(const std::vector<std::pair<double, double>>& samples)
+{
+    double mx = 0, my = 0;
+    for (const auto& [x, y] : samples) {
+        mx += std::log(x);
+        my += std::log(y);
+    }
+    mx /= samples.size();
+    my /= samples.size();
+
+    double sxy = 0, sxx = 0;
+    for (const auto& [x, y] : samples) {
+        sxy += (std::log(x) - mx) * (std::log(y) - my);
+        sxx += (std::log(x) - mx) * (std::log(x) - mx);
+    }
+    return sxy / sxx;
+}
+
+static void writeFile(const std::string& file, const std::string& content)
+{
+    std::ofstream f(file.c_str());
+    if (!f) throw std::runtime_error(std::string("Failed to open file '") + file + "'");
+    f << content;
+}
+
+// Kovacs-style domain with n actions, each one constrained by the next one
+// (all but the last refer to an action that has not been parsed yet)
+static std::string concurrencyDomain(unsigned n)
+{
+    std::ostringstream os;
+    os << "(define (domain scaling)\n";
+    os << "(:requirements :typing :multi-agent)\n";
+    os << "(:types agent obj)\n";
+    os << "(:predicates (ready ?a - agent ?o - obj) (used ?o - obj))\n";
+    for (unsigned i = 0; i < n; ++i) {
+        os << "(:action act" << i << "\n";
+        os << "\t:agent ?a - agent\n";
+        os << "\t:parameters (?o - obj)\n";
+        os << "\t:precondition (and (ready ?a ?o) (forall (?a2 - agent) (not (act" << (i + 1) % n << " ?a2 ?o))))\n";
+        os << "\t:effect (and (used ?o) (not (ready ?a ?o)))\n";
+        os << ")\n";
+    }
+    os << ")\n";
+    return os.str();
+}
+
+// concurrency network domain with n actions, one node per action and the
+// nodes connected in pairs by positive dependences
+static std::string networkDomain(unsigned n)
+{
+    std::ostringstream os;
+    os << "(define (domain scaling)\n";
+    os << "(:requirements :typing :concurrency-network :multi-agent)\n";
+    os << "(:types agent obj)\n";
+    os << "(:predicates (ready ?a - agent ?o - obj) (used ?o - obj))\n";
+    for (unsigned i = 0; i < n; ++i) {
+        os << "(:action act" << i << "\n";
+        os << "\t:agent ?a - agent\n";
+        os << "\t:parameters (?o - obj)\n";
+        os << "\t:precondition (ready ?a ?o)\n";
+        os << "\t:effect (and (used ?o) (not (ready ?a ?o)))\n";
+        os << ")\n";
+    }
+    for (unsigned i = 0; i < n; ++i) {
+        os << "(:concurrency-constraint v" << i << "\n";
+        os << "\t:parameters (?o - obj)\n";
+        os << "\t:bounds (1 2)\n";
+        os << "\t:actions ( (act" << i << " 1) )\n";
+        os << ")\n";
+    }
+    for (unsigned i = 0; i + 1 < n; i += 2)
+        os << "(:positive-dependence v" << i << " v" << i + 1 << ")\n";
+    os << ")\n";
+    return os.str();
+}
+
+// problem with n agents, n objects and 2n init facts
+static std::string problem(unsigned n)
+{
+    std::ostringstream os;
+    os << "(define (problem scaling" << n << ") (:domain scaling)\n";
+    os << "(:objects\n\t";
+    for (unsigned i = 0; i < n; ++i) os << "a" << i << " ";
+    os << "- agent\n\t";
+    for (unsigned i = 0; i < n; ++i) os << "o" << i << " ";
+    os << "- obj\n)\n";
+    os << "(:init\n";
+    for (unsigned i = 0; i < n; ++i) os << "\t(ready a" << i << " o" << i << ")\n";
+    for (unsigned i = 0; i < n; ++i) os << "\t(ready a" << i << " o" << (i + 1) % n << ")\n";
+    os << ")\n";
+    os << "(:goal (and\n";
+    for (unsigned i = 0; i < n; ++i) os << "\t(used o" << i << ")\n";
+    os << "))\n)\n";
+    return os.str();
+}
+
+// number of ground actions of a classical task when every parameter takes
+// every object of its type, as a grounder without static pruning does
+static double groundActions(const parser::pddl::Domain& cd)
+{
+    double total = 0;
+    for (const auto& a : cd.actions) {
+        double n = 1;
+        for (int t : a->params)
+            n *= cd.types[t]->noObjects();
+        total += n;
+    }
+    return total;
+}
+
+class ScalingTests : public testing::Test
+{
+public:
+    std::vector<unsigned> sizes = { 250, 500, 1000, 2000 };
+    unsigned repetitions = 5;
+
+    // runs the pipeline for all sizes and checks the exponents of each phase
+    void checkScaling(const std::string& family, const Pipeline& pipeline)
+    {
+        std::map<std::string, std::vector<std::pair<double, double>>> times, allocations;
+        for (unsigned n : sizes) {
+            PhaseCosts best;
+            for (unsigned r = 0; r < repetitions; ++r)
+                for (const auto& [phase, cost] : pipeline(n))
+                    if (!best.contains(phase) || cost.seconds < best[phase].seconds)
+                        best[phase] = cost;
+            for (const auto& [phase, cost] : best) {
+                times[phase].emplace_back(n, std::max(cost.seconds, 1e-6));
+                allocations[phase].emplace_back(n, std::max(cost.allocations, 1ul));
+            }
+        }
+
+        for (const auto& [phase, s] : times) {
+            double k = fitExponent(s), ka = fitExponent(allocations[phase]);
+            std::cout << family << " / " << phase << ": exponent " << k << ", " << ka << " in allocations";
+            for (unsigned i = 0; i < s.size(); ++i)
+                std::cout << "  " << s[i].first << ":" << s[i].second * 1000 << "ms," << allocations[phase][i].second;
+            std::cout << "\n";
+            EXPECT_LE(ka, maxExponent()) << family << " / " << phase << " allocates as n^" << ka;
+            EXPECT_LE(k, timingExponent()) << family << " / " << phase << " scales as n^" << k;
+        }
+    }
+
+    static PhaseCosts concurrencyActions(unsigned n)
+    {
+        writeFile("scaling_dom.pddl", concurrencyDomain(n));
+        writeFile("scaling_ins.pddl", problem(4));
+
+        PhaseCosts t;
+        parser::multiagent::ConcurrencyCompiler compiler;
+        std::unique_ptr<parser::multiagent::ConcurrencyDomain> d;
+        std::shared_ptr<parser::pddl::Domain> cd;
+        t["parse domain"] = measureCost([&] {
+            d = std::make_unique<parser::multiagent::ConcurrencyDomain>("scaling_dom.pddl");
+            compiler.prepareDomain(*d);
+        });
+        parser::pddl::Instance ins(*d, "scaling_ins.pddl");
+        t["compile domain"] = measureCost([&] { cd = compiler.compileDomain(*d); });
+        t["print domain"] = measureCost([&] { std::ostringstream os; os << *d << *cd; });
+        return t;
+    }
+
+    static PhaseCosts concurrencyAgents(unsigned n)
+    {
+        writeFile("scaling_dom.pddl", concurrencyDomain(4));
+        writeFile("scaling_ins.pddl", problem(n));
+
+        PhaseCosts t;
+        parser::multiagent::ConcurrencyCompiler compiler(true, 4);
+        parser::multiagent::ConcurrencyDomain d("scaling_dom.pddl");
+        compiler.prepareDomain(d);
+        std::unique_ptr<parser::pddl::Instance> ins;
+        std::shared_ptr<parser::pddl::Instance> ci;
+        t["parse instance"] = measureCost([&] { ins = std::make_unique<parser::pddl::Instance>(d, "scaling_ins.pddl"); });
+        auto cd = compiler.compileDomain(d);
+        t["compile instance"] = measureCost([&] { ci = compiler.compileInstance(*cd, *ins); });
+        t["print instance"] = measureCost([&] { std::ostringstream os; os << *ci; });
+        return t;
+    }
+
+    static PhaseCosts networkNodes(unsigned n)
+    {
+        writeFile("scaling_dom.pddl", networkDomain(n));
+        writeFile("scaling_ins.pddl", problem(4));
+
+        PhaseCosts t;
+        std::unique_ptr<parser::multiagent::MultiagentDomain> d;
+        std::shared_ptr<parser::pddl::Domain> cd;
+        t["parse domain"] = measureCost([&] { d = std::make_unique<parser::multiagent::MultiagentDomain>("scaling_dom.pddl"); });
+        parser::pddl::Instance ins(*d, "scaling_ins.pddl");
+        t["compile domain"] = measureCost([&] { cd = parser::multiagent::NetworkCompiler(*d).compileDomain(); });
+        t["print domain"] = measureCost([&] { std::ostringstream os; os << *d << *cd; });
+        return t;
+    }
+
+    static PhaseCosts networkAgents(unsigned n)
+    {
+        writeFile("scaling_dom.pddl", networkDomain(4));
+        writeFile("scaling_ins.pddl", problem(n));
+
+        PhaseCosts t;
+        parser::multiagent::MultiagentDomain d("scaling_dom.pddl");
+        std::unique_ptr<parser::pddl::Instance> ins;
+        std::shared_ptr<parser::pddl::Instance> ci;
+        t["parse instance"] = measureCost([&] { ins = std::make_unique<parser::pddl::Instance>(d, "scaling_ins.pddl"); });
+        parser::multiagent::NetworkCompiler compiler(d);
+        auto cd = compiler.compileDomain();
+        t["compile instance"] = measureCost([&] { ci = compiler.compileInstance(*cd, *ins); });
+        t["print instance"] = measureCost([&] { std::ostringstream os; os << *ci; });
+        return t;
+    }
+
+    // ground actions of the network compilation against the number of agents
+    // with the AGENT-COUNT encoding and with bounded counters; the counters
+    // are the only difference, so the bounded encoding must stay quadratic
+    // (one agent and one object per DO- action) while AGENT-COUNT adds two
+    // parameters with n + 1 values each
+    void checkCounters()
+    {
+        writeFile("scaling_dom.pddl", networkDomain(4));
+        std::vector<std::pair<double, double>> counting, bounded;
+        for (unsigned n : { 10, 20, 40, 80 }) {
+            writeFile("scaling_ins.pddl", problem(n));
+            parser::multiagent::MultiagentDomain d("scaling_dom.pddl");
+            parser::pddl::Instance ins(d, "scaling_ins.pddl");
+
+            parser::multiagent::NetworkCompiler c(d, true, false), b(d, true, true);
+            auto cd = c.compileDomain(), bd = b.compileDomain();
+            c.compileInstance(*cd, ins);
+            b.compileInstance(*bd, ins);
+            counting.emplace_back(n, groundActions(*cd));
+            bounded.emplace_back(n, groundActions(*bd));
+            std::cout << "network counters / " << n << " agents: " << counting.back().second
+                      << " ground actions with AGENT-COUNT, " << bounded.back().second << " bounded\n";
+        }
+
+        double kc = fitExponent(counting), kb = fitExponent(bounded);
+        std::cout << "network counters: exponent " << kc << " with AGENT-COUNT, " << kb << " bounded\n";
+        EXPECT_LE(kb, 2.1);
+        EXPECT_LT(kb, kc);
+    }
+};
+
+TEST_F(ScalingTests, ConcurrencyActions)
+{
+    checkScaling("concurrency actions", concurrencyActions);
+}
+
+TEST_F(ScalingTests, ConcurrencyAgents)
+{
+    checkScaling("concurrency agents", concurrencyAgents);
+}
+
+TEST_F(ScalingTests, NetworkNodes)
+{
+    checkScaling("network nodes", networkNodes);
+}
+
+TEST_F(ScalingTests, NetworkAgents)
+{
+    checkScaling("network agents", networkAgents);
+}
+
+TEST_F(ScalingTests, NetworkCounters)
+{
+    checkCounters();
+}
+
+// :init block of n facts padded with blanks, as in large generated problems
+static std::string initBlock(unsigned n)
+{
+    std::ostringstream os;
+    os << "(:init\n";
+    for (unsigned i = 0; i < n; ++i)
+        os << "\t\t(connected-wireless-link    node-" << i << "        node-" << (i * 7919) % n << "   )   \n";
+    os << ")\n";
+    return os.str();
+}
+
+// tokens of the n facts of initBlock, read with the given next and getToken
+template<typename Next, typename Token>
+static std::vector<std::string> readFacts(const std::string& file, unsigned n, Next next, Token token)
+{
+    parser::pddl::Filereader f(file);
+    std::vector<std::string> tokens;
+    next(f);
+    ++f.c;
+    next(f);
+    tokens.push_back(token(f));
+    for (unsigned i = 0; i < n; ++i) {
+        next(f);
+        ++f.c;
+        for (unsigned k = 0; k < 3; ++k) {
+            next(f);
+            tokens.push_back(token(f));
+        }
+        next(f);
+        ++f.c;
+    }
+    return tokens;
+}
+
+// the bulk scanner reads the same tokens as the Filereader, and faster
+TEST(ScannerTests, InitBlock)
+{
+    unsigned n = 200000;
+    writeFile("scanner_ins.pddl", initBlock(n));
+
+    std::vector<std::string> reader, bulk;
+    double readerTime = measure([&]() {
+        reader = readFacts("scanner_ins.pddl", n, [](parser::pddl::Filereader& f) { f.next(); },
+                           [](parser::pddl::Filereader& f) { return f.getToken(); });
+    });
+    double bulkTime = measure([&]() {
+        bulk = readFacts("scanner_ins.pddl", n, parser::multiagent::scanNext, parser::multiagent::scanToken);
+    });
+
+    std::cout << "scanner (" << parser::multiagent::scannerInstructions() << "): " << 3 * n << " tokens in "
+              << bulkTime << " s, Filereader " << readerTime << " s\n";
+    ASSERT_EQ(reader, bulk);
+    ASSERT_EQ(bulk[0], ":INIT");
+    ASSERT_EQ(bulk[1], "CONNECTED-WIRELESS-LINK");
+}
+
+// building the indexes of a column store of n binary facts and matching a
+// fixed number of partial bindings against it grows linearly with n
+TEST(FactStoreTests, Columns)
+{
+    std::vector<std::pair<double, double>> samples;
+    for (unsigned n : { 250000, 500000, 1000000, 2000000 }) {
+        unsigned objects = n / 8;
+        parser::multiagent::PredicateColumns t(2);
+        for (unsigned i = 0; i < n; ++i)
+            t.add(IntVec{ int(i % objects), int((i * 7919ull) % objects) });
+
+        double best = 0;
+        for (unsigned r = 0; r < 5; ++r) {
+            unsigned found = 0;
+            double seconds = measure([&] {
+                t.index(objects);
+                for (unsigned k = 0; k < 1000; ++k) {
+                    found += t.match(IntVec{ int(k), -1 }).size();
+                    found += t.match(IntVec{ -1, int(k) }).size();
+                }
+            });
+            ASSERT_EQ(found, 16000u);
+            if (r == 0 || seconds < best) best = seconds;
+        }
+        samples.emplace_back(n, std::max(best, 1e-6));
+        std::cout << "fact store / " << n << " facts: " << best * 1000 << "ms\n";
+    }
+
+    double k = fitExponent(samples);
+    std::cout << "fact store: exponent " << k << "\n";
+    EXPECT_LE(k, timingExponent());
+}
+
+// Compile time, allocations and nodes shared with the source domain of the
+// concurrency compilation of the generated tablemover domains. As a
+// baseline, the conditions of the compiled actions are then deep copied,
+// which is what the compiled domain would cost if it shared no nodes (each
+// compiled action had its own copy of its conditions before they were
+// shared), and both are printed side by side.
+TEST(SharingTests, Tablemover)
+{
+    for (unsigned n : { 1, 2, 4, 8 }) {
+        std::string file = "domains/tablemover/domain/table_domain" + std::to_string(n) + ".pddl";
+        parser::multiagent::ConcurrencyDomain d(file);
+        parser::multiagent::ConcurrencyCompiler compiler(true, 2);
+        compiler.prepareDomain(d);
+
+        std::shared_ptr<parser::pddl::Domain> cd;
+        unsigned long allocated = 0;
+        double seconds = measure([&] { allocated = countAllocations([&] { cd = compiler.compileDomain(d); }); });
+
+        parser::pddl::CondVec copies;
+        unsigned long copied = 0;
+        double copySeconds = measure([&] {
+            copied = countAllocations([&] {
+                for (const auto& a : cd->actions) {
+                    if (a->pre) copies.push_back(a->pre->copy(*cd));
+                    if (a->eff) copies.push_back(a->eff->copy(*cd));
+                }
+            });
+        });
+
+        auto [nodes, shared] = parser::multiagent::sharedNodes(d, *cd);
+        std::cout << file << ": compiled in " << seconds * 1000 << " ms with " << allocated << " allocations; "
+                  << shared << " of " << nodes << " condition nodes shared with the source domain; deep copies of the "
+                  << "compiled conditions take " << copySeconds * 1000 << " ms and " << copied << " allocations more\n";
+        EXPECT_GT(shared, 0u);
+        EXPECT_GT(copied, 0u);
+    }
+}
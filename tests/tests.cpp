@@ -7,6 +7,24 @@
 #include <parser/Instance.h>
 #include <multiagent/MultiagentDomain.h>
 #include <multiagent/ConcurrencyDomain.h>
+#include <multiagent/ConcurrencyCompiler.h>
+#include <multiagent/Decomposition.h>
+#include <multiagent/Delta.h>
+#include <multiagent/DomainCache.h>
+#include <multiagent/FactStore.h>
+#include <multiagent/FactTable.h>
+#include <multiagent/FrozenDomain.h>
+#include <multiagent/Keywords.h>
+#include <multiagent/Liveness.h>
+#include <multiagent/NetworkCompiler.h>
+#include <multiagent/Parallel.h>
+#include <multiagent/Projection.h>
+#include <multiagent/SharedConditions.h>
+#include <multiagent/Simplifier.h>
+#include <multiagent/StaticPredicates.h>
+#include <multiagent/Statistics.h>
+#include <multiagent/Symmetry.h>
+#include <multiagent/TypeHierarchy.h>
 
 template<typename T>
 void checkEqual(T& prob, const std::string& file)
@@ -84,6 +102,1102 @@ public:
     }
 };
 
+class SimplifyTests : public testing::Test
+{
+public:
+
+    // the simplification never grows the domain and a second pass changes nothing
+    void checkSimplify( const std::string& name, parser::pddl::Domain& cd ) {
+        SCOPED_TRACE( name );
+        parser::multiagent::Simplifier first, second;
+        first.simplify( cd );
+        ASSERT_LE( first.sizeAfter, first.sizeBefore );
+
+        std::ostringstream before, after;
+        before << cd;
+        second.simplify( cd );
+        after << cd;
+        ASSERT_EQ( before.str(), after.str() );
+        ASSERT_EQ( second.sizeBefore, second.sizeAfter );
+    }
+
+    void networkSimplifyTest( const std::string& domain ) {
+        parser::multiagent::MultiagentDomain dom( domain );
+        checkSimplify( domain, *parser::multiagent::NetworkCompiler( dom ).compileDomain() );
+    }
+
+    void concurrencySimplifyTest( const std::string& domain ) {
+        parser::multiagent::ConcurrencyCompiler compiler;
+        parser::multiagent::ConcurrencyDomain dom( domain );
+        compiler.prepareDomain( dom );
+        checkSimplify( domain, *compiler.compileDomain( dom ) );
+    }
+
+    // literals of a conjunction as (negated, name, params)
+    typedef std::vector< std::tuple< bool, std::string, IntVec > > Literals;
+    static Literals literals( const std::shared_ptr< parser::pddl::Condition >& c ) {
+        Literals result;
+        auto a = std::dynamic_pointer_cast< parser::pddl::And >( c );
+        EXPECT_TRUE( a != nullptr );
+        if ( !a ) return result;
+        for ( const auto& child : a->conds ) {
+            auto g = std::dynamic_pointer_cast< parser::pddl::Ground >( child );
+            auto n = std::dynamic_pointer_cast< parser::pddl::Not >( child );
+            EXPECT_TRUE( g != nullptr || n != nullptr );
+            if ( g ) result.emplace_back( false, g->name, g->params );
+            else if ( n ) result.emplace_back( true, n->cond->name, n->cond->params );
+        }
+        return result;
+    }
+
+    // repeated and nested literals are removed, a delete effect of an atom that
+    // the same conjunction adds is dropped and an action that requires p and
+    // not p is deleted
+    void handBuiltSimplifyTest() {
+        using namespace parser::pddl;
+        Domain cd;
+        cd.createType( "OBJ" );
+        cd.createPredicate( "P", StringVec( 2, "OBJ" ) );
+        cd.createPredicate( "Q", StringVec( 1, "OBJ" ) );
+        auto p = [&]( int x, int y ) { return std::make_shared< Ground >( cd.preds.get( "P" ), IntVec{ x, y } ); };
+        auto q = [&]( int x ) { return std::make_shared< Ground >( cd.preds.get( "Q" ), IntVec{ x } ); };
+
+        auto dup = cd.createAction( "DUP", StringVec( 2, "OBJ" ) );
+        auto nested = std::make_shared< And >();
+        nested->add( p( 0, 1 ) );
+        nested->add( q( 1 ) );
+        auto pre = std::make_shared< And >();
+        pre->add( p( 0, 1 ) );
+        pre->add( nested );
+        pre->add( std::make_shared< Not >( q( 0 ) ) );
+        pre->add( std::make_shared< Not >( q( 0 ) ) );
+        pre->add( p( 1, 0 ) );
+        dup->pre = pre;
+        auto eff = std::make_shared< And >();
+        eff->add( std::make_shared< Not >( q( 0 ) ) );
+        eff->add( q( 0 ) );
+        eff->add( std::make_shared< Not >( p( 0, 1 ) ) );
+        eff->add( q( 0 ) );
+        dup->eff = eff;
+
+        auto contradiction = cd.createAction( "CONTRADICTION", StringVec( 1, "OBJ" ) );
+        auto cpre = std::make_shared< And >();
+        cpre->add( q( 0 ) );
+        cpre->add( std::make_shared< Not >( q( 0 ) ) );
+        contradiction->pre = cpre;
+        auto ceff = std::make_shared< And >();
+        ceff->add( q( 0 ) );
+        contradiction->eff = ceff;
+
+        parser::multiagent::Simplifier simplifier;
+        simplifier.simplify( cd );
+        ASSERT_EQ( simplifier.actionsBefore, 2u );
+        ASSERT_EQ( simplifier.actionsAfter, 1u );
+        ASSERT_EQ( cd.actions.size(), 1u );
+        ASSERT_EQ( cd.actions[0]->name, "DUP" );
+
+        Literals expectedPre = { { false, "P", { 0, 1 } }, { false, "Q", { 1 } }, { true, "Q", { 0 } }, { false, "P", { 1, 0 } } };
+        Literals expectedEff = { { false, "Q", { 0 } }, { true, "P", { 0, 1 } } };
+        ASSERT_EQ( literals( cd.actions[0]->pre ), expectedPre );
+        ASSERT_EQ( literals( cd.actions[0]->eff ), expectedEff );
+        ASSERT_EQ( simplifier.sizeBefore, 23u );
+        ASSERT_EQ( simplifier.sizeAfter, 10u );
+
+        // the nodes of the original conditions are not modified
+        ASSERT_EQ( pre->conds.size(), 5u );
+        ASSERT_EQ( eff->conds.size(), 4u );
+    }
+};
+
+class StaticTests : public testing::Test
+{
+public:
+
+    void mazeStaticTest() {
+        parser::multiagent::MultiagentDomain dom( "domains/maze/domain/maze_dom_cn.pddl" );
+        std::set<std::string> names;
+        for (unsigned i : parser::multiagent::staticPredicates( dom ))
+            names.insert( dom.preds[i]->name );
+        ASSERT_EQ( names, std::set<std::string>( { "HAS-SWITCH", "HAS-DOOR", "HAS-BOAT" } ) );
+    }
+
+    // specialising the actions keeps the signature of the classical domain
+    // (and hence the classical instance) and the number of actions
+    void networkStaticTest() {
+        parser::multiagent::MultiagentDomain dom( "domains/maze/domain/maze_dom_cn.pddl" );
+        parser::pddl::Instance ins( dom, "domains/maze/problems/maze5_4_1.pddl" );
+        parser::multiagent::NetworkCompiler keep( dom, false ), inlined( dom, true );
+
+        auto kd = keep.compileDomain(), id = inlined.compileDomain();
+        ASSERT_EQ( kd->actions.size(), id->actions.size() );
+        ASSERT_GT( parser::multiagent::Simplifier::size( id->actions.get( "START-V2" )->pre ),
+                   parser::multiagent::Simplifier::size( kd->actions.get( "START-V2" )->pre ) );
+
+        std::ostringstream ki, ii;
+        ki << *keep.compileInstance( *kd, ins );
+        ii << *inlined.compileInstance( *id, ins );
+        ASSERT_EQ( ki.str(), ii.str() );
+    }
+};
+
+class DecompositionTests : public testing::Test
+{
+public:
+
+    // two agents that work on different objects are split into two
+    // subproblems, each with its own objects, facts and goals
+    void independentAgentsTest() {
+        std::ofstream( "decomposition_dom.pddl" ) <<
+            "(define (domain decomposition)\n"
+            "(:requirements :typing :concurrency-network :multi-agent)\n"
+            "(:types agent obj)\n"
+            "(:predicates (ready ?a - agent ?o - obj) (used ?o - obj))\n"
+            "(:action act\n"
+            "\t:agent ?a - agent\n"
+            "\t:parameters (?o - obj)\n"
+            "\t:precondition (ready ?a ?o)\n"
+            "\t:effect (and (used ?o) (not (ready ?a ?o)))\n"
+            ")\n"
+            "(:concurrency-constraint v\n"
+            "\t:parameters (?o - obj)\n"
+            "\t:bounds (1 2)\n"
+            "\t:actions ( (act 1) )\n"
+            ")\n"
+            ")\n";
+        std::ofstream( "decomposition_ins.pddl" ) <<
+            "(define (problem decomposition) (:domain decomposition)\n"
+            "(:objects a1 a2 - agent o1 o2 o3 - obj)\n"
+            "(:init (ready a1 o1) (ready a2 o2) (ready a2 o3))\n"
+            "(:goal (and (used o1) (used o2) (used o3)))\n"
+            ")\n";
+
+        parser::multiagent::MultiagentDomain dom( "decomposition_dom.pddl" );
+        parser::pddl::Instance ins( dom, "decomposition_ins.pddl" );
+        parser::multiagent::Decomposition decomposition( dom, ins );
+        ASSERT_EQ( decomposition.reason, "" );
+        ASSERT_EQ( decomposition.subproblems.size(), 2u );
+        ASSERT_EQ( decomposition.subproblems[0].agents, StringVec( { "A1" } ) );
+        ASSERT_EQ( decomposition.subproblems[1].agents, StringVec( { "A2" } ) );
+        ASSERT_EQ( decomposition.subproblems[0].goal.size(), 1u );
+        ASSERT_EQ( decomposition.subproblems[1].goal.size(), 2u );
+        ASSERT_EQ( decomposition.subproblems[1].objects.size(), 3u );
+    }
+
+    // in a concurrency domain, act requires that some other agent does act on
+    // any object at the same time; the constraint does not use the parameters
+    // of act and couples all agents, so the problem is not split, while a
+    // constraint on the object of the action keeps the agents independent
+    void concurrencyConstraintTest() {
+        auto check = [&]( const std::string& constraint, bool split ) {
+            std::ofstream( "decomposition_dom.pddl" ) <<
+                "(define (domain decomposition)\n"
+                "(:requirements :typing :multi-agent)\n"
+                "(:types agent obj)\n"
+                "(:predicates (ready ?a - agent ?o - obj) (used ?o - obj))\n"
+                "(:action act\n"
+                "\t:agent ?a - agent\n"
+                "\t:parameters (?o - obj)\n"
+                "\t:precondition (and (ready ?a ?o) " << constraint << ")\n"
+                "\t:effect (and (used ?o) (not (ready ?a ?o)))\n"
+                ")\n"
+                ")\n";
+            std::ofstream( "decomposition_ins.pddl" ) <<
+                "(define (problem decomposition) (:domain decomposition)\n"
+                "(:objects a1 a2 - agent o1 o2 - obj)\n"
+                "(:init (ready a1 o1) (ready a2 o2))\n"
+                "(:goal (and (used o1) (used o2)))\n"
+                ")\n";
+
+            parser::multiagent::ConcurrencyDomain dom( "decomposition_dom.pddl" );
+            parser::pddl::Instance ins( dom, "decomposition_ins.pddl" );
+            parser::multiagent::Decomposition decomposition( dom, ins );
+            if ( split ) {
+                ASSERT_EQ( decomposition.reason, "" );
+                ASSERT_EQ( decomposition.subproblems.size(), 2u );
+            }
+            else {
+                ASSERT_EQ( decomposition.reason, "action ACT reads ACT without using its parameters" );
+                ASSERT_EQ( decomposition.subproblems.size(), 1u );
+            }
+        };
+        check( "(exists (?a2 - agent ?o2 - obj) (and (not (= ?a ?a2)) (act ?a2 ?o2)))", false );
+        check( "(forall (?a2 - agent) (not (act ?a2 ?o)))", true );
+    }
+
+    // the agents of maze share the locations, so maze is not split
+    void mazeTest() {
+        parser::multiagent::MultiagentDomain dom( "domains/maze/domain/maze_dom_cn.pddl" );
+        parser::pddl::Instance ins( dom, "domains/maze/problems/maze5_4_1.pddl" );
+        parser::multiagent::Decomposition decomposition( dom, ins );
+        ASSERT_EQ( decomposition.subproblems.size(), 1u );
+        ASSERT_EQ( decomposition.subproblems[0].init.size(), ins.init.size() );
+    }
+
+    void mergeTest() {
+        std::istringstream p1( "2 0 2\na1\n0: (move a1 l1 l2)\n1: (move a1 l2 l3)\n" ), p2( "0: (push a2 b1)\n" );
+        std::vector< parser::multiagent::JointPlan > plans = { parser::multiagent::readPlan( p1 ), parser::multiagent::readPlan( p2 ) };
+        std::ostringstream os;
+        parser::multiagent::printPlan( os, parser::multiagent::mergePlans( plans ) );
+        ASSERT_EQ( os.str(), "0: (move a1 l1 l2)\n0: (push a2 b1)\n1: (move a1 l2 l3)\n" );
+    }
+};
+
+class DeltaTests : public testing::Test
+{
+public:
+
+    static std::multiset< std::string > facts( const parser::pddl::Domain& d, const parser::pddl::GroundVec& v ) {
+        std::multiset< std::string > s;
+        for (const auto& g : v) {
+            std::string f = g->name;
+            for (const auto& o : d.objectList( *g ))
+                f += " " + o;
+            s.insert( f );
+        }
+        return s;
+    }
+
+    // patching an instance and its compilation gives the compilation of the
+    // patched instance, and changes without effect are not passed on
+    void networkDeltaTest() {
+        parser::multiagent::MultiagentDomain dom( "domains/maze/domain/maze_dom_cn.pddl" );
+        parser::pddl::Instance ins( dom, "domains/maze/problems/maze5_4_1.pddl" );
+        parser::multiagent::NetworkCompiler compiler( dom, true, true );
+        auto cd = compiler.compileDomain();
+        auto cins = compiler.compileInstance( *cd, ins );
+
+        parser::multiagent::InstanceDelta delta;
+        delta.removeInit( "AT", { "A1", "LOC2X3" } );
+        delta.addInit( "AT", { "A1", "LOC2X4" } );
+        delta.addInit( "AT", { "A2", "LOC3X3" } );
+        delta.removeGoal( "AT", { "A1", "LOC2X4" } );
+        delta.addGoal( "AT", { "A1", "LOC1X1" } );
+
+        std::stringstream patch;
+        delta.print( patch );
+        parser::multiagent::InstanceDelta read;
+        read.read( patch );
+        ASSERT_EQ( read.changes.size(), delta.changes.size() );
+
+        parser::multiagent::IncrementalInstance iins( ins ), icins( *cins );
+        auto applied = iins.apply( read );
+        ASSERT_EQ( applied.changes.size(), 4u );
+        ASSERT_EQ( icins.apply( applied ).changes.size(), 4u );
+
+        auto fresh = compiler.compileInstance( *cd, ins );
+        ASSERT_EQ( facts( *cd, cins->init ), facts( *cd, fresh->init ) );
+        ASSERT_EQ( facts( *cd, cins->goal ), facts( *cd, fresh->goal ) );
+
+        // unknown objects, wrong arities and facts that are not there
+        // change nothing
+        parser::multiagent::InstanceDelta ignored;
+        ignored.addInit( "AT", { "A1", "NOWHERE" } );
+        ignored.addGoal( "AT", { "A1" } );
+        ignored.removeInit( "AT", { "A1", "LOC2X3" } );
+        auto init = facts( dom, ins.init ), goal = facts( dom, ins.goal );
+        ASSERT_EQ( iins.apply( ignored ).changes.size(), 0u );
+        ASSERT_EQ( facts( dom, ins.init ), init );
+        ASSERT_EQ( facts( dom, ins.goal ), goal );
+    }
+};
+
+class ProjectionTests : public testing::Test
+{
+public:
+
+    std::map< std::string, parser::multiagent::Projection::AgentTask > byAgent( const parser::multiagent::Projection& projection ) {
+        std::map< std::string, parser::multiagent::Projection::AgentTask > tasks;
+        for (const auto& t : projection.tasks)
+            tasks[t.agent] = t;
+        return tasks;
+    }
+
+    // trucks and airplanes only keep their own actions, agents of the same
+    // type share their domain and the result does not depend on the threads
+    void multilogProjectionTest() {
+        parser::multiagent::MultiagentDomain dom( "domains/multilog/Multilog_dom.pddl" );
+        parser::pddl::Instance ins( dom, "domains/multilog/Multilog_ins.pddl" );
+        parser::multiagent::Projection serial( dom, ins, 1 ), parallel( dom, ins, 4 );
+
+        ASSERT_EQ( serial.agentArg[dom.preds.index( "AT" )], -1 );
+        ASSERT_EQ( serial.agentArg[dom.preds.index( "IN" )], 1 );
+
+        auto tasks = byAgent( serial );
+        ASSERT_EQ( tasks.size(), 3u );
+        ASSERT_EQ( tasks["TRU1"].domain, tasks["TRU2"].domain );
+        ASSERT_NE( tasks["TRU1"].domain, tasks["APN1"].domain );
+        ASSERT_EQ( tasks["TRU1"].domain->actions.size(), 3u );
+        ASSERT_GE( tasks["TRU1"].domain->actions.index( "DRIVE-TRUCK" ), 0 );
+        ASSERT_LT( tasks["APN1"].domain->actions.index( "DRIVE-TRUCK" ), 0 );
+        ASSERT_EQ( tasks["APN1"].instance->init.size(), ins.init.size() + 1 );
+
+        auto ptasks = byAgent( parallel );
+        for (const auto& [agent, t] : tasks) {
+            std::ostringstream s, p;
+            s << *t.domain << *t.instance;
+            p << *ptasks[agent].domain << *ptasks[agent].instance;
+            ASSERT_EQ( s.str(), p.str() );
+        }
+    }
+
+    // names of the literals of condition c
+    static void groundNames( const std::shared_ptr< parser::pddl::Condition >& c, std::set< std::string >& names ) {
+        using namespace parser::pddl;
+        if (auto g = std::dynamic_pointer_cast< Ground >( c ))
+            names.insert( g->name );
+        else if (auto n = std::dynamic_pointer_cast< Not >( c ))
+            groundNames( n->cond, names );
+        else if (auto a = std::dynamic_pointer_cast< And >( c ))
+            for (const auto& child : a->conds)
+                groundNames( child, names );
+        else if (auto o = std::dynamic_pointer_cast< Or >( c )) {
+            groundNames( o->first, names );
+            groundNames( o->second, names );
+        }
+        else if (auto f = std::dynamic_pointer_cast< Forall >( c ))
+            groundNames( f->cond, names );
+        else if (auto e = std::dynamic_pointer_cast< Exists >( c ))
+            groundNames( e->cond, names );
+    }
+
+    // the concurrency constraints of maze (literals on the actions of other
+    // agents) are dropped from the preconditions and are not predicates of
+    // the projected domain
+    void mazeConcurrencyProjectionTest() {
+        parser::multiagent::ConcurrencyDomain dom( "domains/maze/domain/maze_dom_cal.pddl" );
+        parser::pddl::Instance ins( dom, "domains/maze/problems/maze5_4_1.pddl" );
+        parser::multiagent::Projection projection( dom, ins );
+
+        ASSERT_EQ( projection.tasks.size(), 5u );
+        auto pd = projection.tasks[0].domain;
+        for (const auto& t : projection.tasks)
+            ASSERT_EQ( t.domain, pd );
+        ASSERT_EQ( pd->actions.size(), dom.actions.size() );
+        for (const auto& cp : dom.cpreds)
+            ASSERT_LT( pd->preds.index( cp->name ), 0 ) << cp->name;
+        for (const auto& a : pd->actions) {
+            std::set< std::string > names;
+            groundNames( a->pre, names );
+            for (const auto& name : names)
+                ASSERT_LT( dom.cpreds.index( name ), 0 ) << a->name << " requires " << name;
+        }
+        ASSERT_GE( pd->preds.index( "AT" ), 0 );
+        ASSERT_GE( pd->preds.index( "SELF" ), 0 );
+    }
+};
+
+class CounterTests : public testing::Test
+{
+public:
+
+    // bounded counters replace the two AGENT-COUNT parameters of DO- actions
+    // by one predicate per value between zero and the bound of the node
+    void networkCounterTest() {
+        parser::multiagent::MultiagentDomain dom( "domains/maze/domain/maze_dom_cn.pddl" );
+        parser::pddl::Instance ins( dom, "domains/maze/problems/maze5_4_1.pddl" );
+        parser::multiagent::NetworkCompiler counting( dom, true, false ), bounded( dom, true, true );
+
+        auto cd = counting.compileDomain(), bd = bounded.compileDomain();
+        ASSERT_EQ( cd->actions.size(), bd->actions.size() );
+        ASSERT_EQ( cd->actions.get( "DO-ROW" )->params.size(), bd->actions.get( "DO-ROW" )->params.size() + 2 );
+        ASSERT_LT( bd->preds.index( "CONSEC" ), 0 );
+
+        // v2 has bounds (2 inf), so its counter saturates at 2
+        ASSERT_EQ( bounded.counterBound( 1 ), 2u );
+        ASSERT_GE( bd->preds.index( "COUNT-V2-2" ), 0 );
+        ASSERT_LT( bd->preds.index( "COUNT-V2-3" ), 0 );
+
+        auto bins = bounded.compileInstance( *bd, ins );
+        for (auto& g : bins->init)
+            ASSERT_NE( g->name.substr( 0, 4 ), "SAT-" );
+    }
+};
+
+class SymmetryTests : public testing::Test
+{
+public:
+
+    void checkOrbits( const std::string& domain, const std::string& problem, const std::vector< StringVec >& orbits ) {
+        parser::multiagent::MultiagentDomain dom( domain );
+        parser::pddl::Instance ins( dom, problem );
+        parser::multiagent::AgentSymmetry symmetry( dom, ins );
+        ASSERT_EQ( symmetry.orbits, orbits );
+    }
+
+    // agents with the same initial facts and goals are interchangeable, and
+    // the network compilation orders the agents of each orbit
+    void networkSymmetryTest() {
+        checkOrbits( "domains/maze/domain/maze_dom_cn.pddl", "domains/maze/problems/maze5_4_1.pddl", {} );
+        checkOrbits( "domains/tablemover/domain/Tablemover_dom_cn.pddl", "domains/tablemover/problems/table4_4_1.pddl", { { "A0", "A1" } } );
+
+        parser::multiagent::MultiagentDomain dom( "domains/workshop/domain/workshop_dom_cn.pddl" );
+        parser::pddl::Instance ins( dom, "domains/workshop/problems/workshop1_1.pddl" );
+        parser::multiagent::AgentSymmetry symmetry( dom, ins );
+        ASSERT_EQ( symmetry.orbits, std::vector< StringVec >( 1, { "A1", "A2" } ) );
+        ASSERT_EQ( symmetry.permutations(), 2 );
+
+        parser::multiagent::NetworkCompiler plain( dom ), ordered( dom, true, false, true );
+        auto pd = plain.compileDomain(), od = ordered.compileDomain();
+        ASSERT_EQ( pd->actions.size(), od->actions.size() );
+        ASSERT_LT( pd->preds.index( "SYM-PREV" ), 0 );
+        ASSERT_GE( od->preds.index( "ACTED" ), 0 );
+
+        auto pins = plain.compileInstance( *pd, ins ), oins = ordered.compileInstance( *od, ins );
+        ASSERT_EQ( oins->init.size(), pins->init.size() + 1 );
+    }
+};
+
+class StatisticsTests : public testing::Test
+{
+public:
+
+    static double groundActions( const parser::pddl::Domain& cd ) {
+        double total = 0;
+        for (const auto& a : cd.actions) {
+            double n = 1;
+            for (int t : a->params)
+                n *= cd.types[t]->noObjects();
+            total += n;
+        }
+        return total;
+    }
+
+    // the predicted size of the compiled task is the size of its grounding
+    // by types, and static preconditions never increase the estimate
+    void networkStatisticsTest( const std::string& domain, const std::string& problem ) {
+        parser::multiagent::MultiagentDomain dom( domain );
+        parser::pddl::Instance ins( dom, problem );
+        parser::multiagent::DomainStatistics stats( dom, ins );
+        ASSERT_EQ( stats.actions.size(), dom.actions.size() );
+        ASSERT_EQ( stats.nodes.size(), dom.nodes.size() );
+        ASSERT_LE( stats.groundActions().estimate, stats.groundActions().naive );
+
+        for (bool bounded : { false, true }) {
+            parser::multiagent::NetworkCompiler compiler( dom, true, bounded );
+            auto cd = compiler.compileDomain();
+            compiler.compileInstance( *cd, ins );
+            auto size = stats.compiledSize( compiler );
+            ASSERT_EQ( size.naive, groundActions( *cd ) );
+            ASSERT_LE( size.estimate, size.naive );
+        }
+    }
+
+    void concurrencyStatisticsTest( const std::string& domain, const std::string& problem ) {
+        parser::multiagent::ConcurrencyCompiler compiler( true, 2 );
+        parser::multiagent::ConcurrencyDomain dom( domain );
+        compiler.prepareDomain( dom );
+        parser::pddl::Instance ins( dom, problem );
+        parser::multiagent::DomainStatistics stats( dom, ins );
+        ASSERT_TRUE( stats.nodes.empty() );
+
+        auto cd = compiler.compileDomain( dom );
+        compiler.compileInstance( *cd, ins );
+        auto size = stats.compiledSize( compiler );
+        ASSERT_EQ( size.naive, groundActions( *cd ) );
+        ASSERT_LE( size.estimate, size.naive );
+    }
+
+    // a concurrency constraint in a precondition is not a static fact, so it
+    // does not make the estimate of the action zero
+    void concurrencyConstraintTest() {
+        std::ofstream( "statistics_dom.pddl" ) <<
+            "(define (domain statistics)\n"
+            "(:requirements :typing :multi-agent)\n"
+            "(:types agent obj)\n"
+            "(:predicates (ready ?a - agent ?o - obj) (lifted ?o - obj))\n"
+            "(:action lift\n"
+            "\t:agent ?a - agent\n"
+            "\t:parameters (?a2 - agent ?o - obj)\n"
+            "\t:precondition (and (ready ?a ?o) (lift ?a2 ?a ?o))\n"
+            "\t:effect (and (lifted ?o) (not (ready ?a ?o)))\n"
+            ")\n"
+            ")\n";
+        std::ofstream( "statistics_ins.pddl" ) <<
+            "(define (problem statistics) (:domain statistics)\n"
+            "(:objects a1 a2 - agent o1 - obj)\n"
+            "(:init (ready a1 o1) (ready a2 o1))\n"
+            "(:goal (lifted o1))\n"
+            ")\n";
+
+        parser::multiagent::ConcurrencyDomain dom( "statistics_dom.pddl" );
+        parser::pddl::Instance ins( dom, "statistics_ins.pddl" );
+        parser::multiagent::DomainStatistics stats( dom, ins );
+        ASSERT_EQ( stats.actions.size(), 1u );
+        ASSERT_EQ( stats.actions[0].size.naive, 4 );
+        ASSERT_EQ( stats.actions[0].size.estimate, 4 );
+    }
+};
+
+class FactTests : public testing::Test
+{
+public:
+
+    // each distinct atom is kept once
+    void tableTest() {
+        parser::multiagent::FactTable table;
+        IntVec a = { 1, 2 }, b = { 2, 1 };
+        ASSERT_EQ( table.insert( 0, a ), 0u );
+        ASSERT_EQ( table.insert( 0, b ), 1u );
+        ASSERT_EQ( table.insert( 1, a ), 2u );
+        ASSERT_EQ( table.insert( 0, IntVec{ 1, 2 } ), 0u );
+        ASSERT_EQ( table.find( 1, b ), -1 );
+        ASSERT_EQ( table.size(), 3u );
+        ASSERT_EQ( table.pred( 2 ), 1 );
+        ASSERT_EQ( IntVec( table.args( 1 ).begin(), table.args( 1 ).end() ), b );
+    }
+
+    // atoms copied by id are the ones copied through their names
+    void copierTest() {
+        parser::multiagent::MultiagentDomain dom( "domains/maze/domain/maze_dom_cn.pddl" );
+        parser::pddl::Instance ins( dom, "domains/maze/problems/maze5_4_1.pddl" );
+        auto cd = parser::multiagent::NetworkCompiler( dom ).compileDomain();
+
+        parser::multiagent::FactCopier copier( dom, *cd );
+        parser::pddl::Instance byId( *cd ), byName( *cd );
+        for (const auto& g : ins.init) {
+            if ( dom.preds.index( g->name ) < 0 ) continue;
+            ASSERT_TRUE( copier.copyInit( *g, byId ) );
+            byName.addInit( g->name, dom.objectList( *g ) );
+        }
+        for (const auto& g : ins.goal) {
+            ASSERT_TRUE( copier.copyGoal( *g, byId ) );
+            byName.addGoal( g->name, dom.objectList( *g ) );
+        }
+
+        std::ostringstream i, n;
+        i << byId;
+        n << byName;
+        ASSERT_EQ( i.str(), n.str() );
+    }
+
+    // facts are kept by predicate with the global ids of their objects
+    void storeTest() {
+        parser::multiagent::MultiagentDomain dom( "domains/maze/domain/maze_dom_cn.pddl" );
+        parser::pddl::Instance ins( dom, "domains/maze/problems/maze5_4_1.pddl" );
+        parser::multiagent::FactStore store( dom, ins );
+
+        unsigned facts = 0;
+        for ( unsigned p = 0; p < dom.preds.size(); ++p ) {
+            ASSERT_EQ( store.facts( p ).arity(), dom.preds[p]->params.size() );
+            facts += store.facts( p ).size();
+        }
+        ASSERT_EQ( facts, ins.init.size() );
+
+        const auto & at = store.facts( dom.preds.index( "AT" ) );
+        auto rows = at.match( IntVec{ store.objectId( "A1" ), -1 } );
+        ASSERT_EQ( rows.size(), 1u );
+        ASSERT_EQ( store.object( at.at( rows[0], 1 ) ), "LOC2X3" );
+        ASSERT_EQ( at.match( IntVec{ -1, store.objectId( "LOC1X4" ) } ).size(), 2u );
+    }
+
+    // the join of the positive precondition of an action finds the bindings
+    // of nested loops over the initial facts
+    void joinTest() {
+        parser::multiagent::MultiagentDomain dom( "domains/maze/domain/maze_dom_cn.pddl" );
+        parser::pddl::Instance ins( dom, "domains/maze/problems/maze5_4_1.pddl" );
+        parser::multiagent::FactStore store( dom, ins );
+
+        auto a = dom.actions[dom.actions.index( "MOVE" )];
+        std::vector< parser::multiagent::JoinAtom > atoms;
+        std::vector< std::shared_ptr< parser::pddl::Ground > > literals;
+        for ( const auto & c : std::dynamic_pointer_cast< parser::pddl::And >( a->pre )->conds ) {
+            if ( auto g = std::dynamic_pointer_cast< parser::pddl::Ground >( c ) ) {
+                atoms.push_back( store.atom( *g ) );
+                literals.push_back( g );
+            }
+        }
+        ASSERT_EQ( atoms.size(), 2u );
+
+        std::set< StringVec > joined, expected;
+        store.join( atoms, a->params.size(), [&]( std::span< const int > b ) {
+            StringVec s;
+            for ( int o : b ) s.push_back( o < 0 ? "" : store.object( o ) );
+            joined.insert( s );
+        } );
+
+        for ( const auto & f : ins.init ) {
+            if ( f->name != literals[0]->name ) continue;
+            for ( const auto & h : ins.init ) {
+                if ( h->name != literals[1]->name ) continue;
+                StringVec b( a->params.size() );
+                bool ok = true;
+                auto bind = [&]( const parser::pddl::Ground & l, const StringVec & objects ) {
+                    for ( unsigned i = 0; i < l.params.size(); ++i ) {
+                        if ( b[l.params[i]].size() && b[l.params[i]] != objects[i] ) ok = false;
+                        b[l.params[i]] = objects[i];
+                    }
+                };
+                bind( *literals[0], dom.objectList( *f ) );
+                bind( *literals[1], dom.objectList( *h ) );
+                if ( ok ) expected.insert( b );
+            }
+        }
+        ASSERT_FALSE( joined.empty() );
+        ASSERT_EQ( joined, expected );
+    }
+};
+
+class SharingTests : public testing::Test
+{
+public:
+
+    // compiling does not change the source domain, whose nodes are shared by
+    // the compiled actions, and compiling it again gives the same domain
+    template<typename Compile>
+    void checkSharing( const parser::pddl::Domain& dom, Compile compile ) {
+        std::ostringstream before, first, second, after;
+        before << dom;
+        auto cd = compile();
+        first << *cd;
+        second << *compile();
+        after << dom;
+        ASSERT_EQ( before.str(), after.str() );
+        ASSERT_EQ( first.str(), second.str() );
+
+        auto [nodes, shared] = parser::multiagent::sharedNodes( dom, *cd );
+        ASSERT_GT( shared, 0u );
+        ASSERT_LT( shared, nodes );
+    }
+
+    void networkSharingTest( const std::string& domain ) {
+        parser::multiagent::MultiagentDomain dom( domain );
+        checkSharing( dom, [&]() { return parser::multiagent::NetworkCompiler( dom ).compileDomain(); } );
+    }
+
+    void concurrencySharingTest( const std::string& domain ) {
+        parser::multiagent::ConcurrencyDomain dom( domain );
+        parser::multiagent::ConcurrencyCompiler compiler( true, 2 );
+        compiler.prepareDomain( dom );
+        checkSharing( dom, [&]() { return compiler.compileDomain( dom ); } );
+    }
+
+    // shifting the parameters of a concurrency ground keeps its class and
+    // its constants, and leaves the original atom unchanged
+    void shiftSubclassTest() {
+        using namespace parser::pddl;
+        using parser::multiagent::ConcurrencyGround;
+        Domain dom;
+        dom.createType( "OBJ" );
+        dom.createPredicate( "P", StringVec( 2, "OBJ" ) );
+        auto g = std::make_shared< ConcurrencyGround >( dom.preds.get( "P" ), IntVec{ 0, 1 } );
+        g->constants[1] = "C";
+
+        auto shifted = std::dynamic_pointer_cast< ConcurrencyGround >( parser::multiagent::shiftParams( dom, g, 1, 2 ) );
+        ASSERT_TRUE( shifted );
+        ASSERT_NE( shifted, g );
+        ASSERT_EQ( shifted->params, IntVec( { 0, 3 } ) );
+        ASSERT_EQ( shifted->constants, g->constants );
+        ASSERT_EQ( g->params, IntVec( { 0, 1 } ) );
+        ASSERT_EQ( parser::multiagent::shiftParams( dom, g, 2, 2 ), g );
+    }
+};
+
+class FrozenTests : public testing::Test
+{
+public:
+
+    // the frozen domain has the elements of the parsed domain in the same order
+    void checkFrozen( const parser::pddl::Domain& dom, const parser::multiagent::FrozenDomain& fd ) {
+        using parser::multiagent::FrozenDomain;
+        ASSERT_EQ( fd.types.size(), dom.types.size() );
+        ASSERT_EQ( fd.preds.size(), dom.preds.size() );
+        for ( unsigned i = 0; i < dom.preds.size(); ++i ) {
+            ASSERT_EQ( fd.preds[i].name, dom.preds[i]->name );
+            auto params = FrozenDomain::part( fd.params, fd.preds[i].params );
+            ASSERT_EQ( IntVec( params.begin(), params.end() ), dom.preds[i]->params );
+        }
+        ASSERT_EQ( fd.actions.size(), dom.actions.size() );
+        for ( unsigned i = 0; i < dom.actions.size(); ++i ) {
+            ASSERT_EQ( fd.actionIndex( dom.actions[i]->name ), int( i ) );
+            ASSERT_EQ( fd.nodes[fd.actions[i].eff].kind, FrozenDomain::AND );
+        }
+        ASSERT_EQ( parser::multiagent::staticPredicates( fd ), parser::multiagent::staticPredicates( dom ) );
+
+        // readers on several threads share the frozen domain
+        std::vector<std::set<unsigned>> found( 8 );
+        parser::multiagent::parallelFor( found.size(), 4, [&]( unsigned job, unsigned ) {
+            found[job] = parser::multiagent::staticPredicates( fd );
+        } );
+        for ( const auto& f : found )
+            ASSERT_EQ( f, found[0] );
+    }
+
+    void concurrencyFrozenTest() {
+        parser::multiagent::ConcurrencyDomain dom( "domains/tablemover/domain/table_domain1.pddl" );
+        auto fd = parser::multiagent::freeze( dom );
+        checkFrozen( dom, *fd );
+
+        ASSERT_TRUE( fd->multiagent );
+        for ( unsigned i = 0; i < dom.preds.size(); ++i )
+            ASSERT_EQ( fd->preds[i].concurrency, dom.cpreds.index( dom.preds[i]->name ) >= 0 );
+    }
+
+    void networkFrozenTest() {
+        parser::multiagent::MultiagentDomain dom( "domains/maze/domain/maze_dom_cn.pddl" );
+        auto fd = parser::multiagent::freeze( dom );
+        checkFrozen( dom, *fd );
+
+        ASSERT_EQ( fd->network.size(), dom.nodes.size() );
+        for ( unsigned i = 0; i < dom.nodes.size(); ++i ) {
+            auto templates = parser::multiagent::FrozenDomain::part( fd->templates, fd->network[i].templates );
+            ASSERT_EQ( templates.size(), dom.nodes[i]->templates.size() );
+            for ( unsigned j = 0; j < templates.size(); ++j )
+                ASSERT_EQ( fd->actions[templates[j].action].signature.name, dom.nodes[i]->templates[j]->name );
+        }
+        ASSERT_TRUE( fd->subtype( fd->typeIndex( "AGENT" ), 0 ) );
+    }
+
+    // increases keep their operands as text with numbered variables
+    void increaseFrozenTest() {
+        parser::multiagent::MultiagentDomain dom( "domains/codmap15/elevators08/domain/domain.pddl" );
+        auto fd = parser::multiagent::freeze( dom );
+        checkFrozen( dom, *fd );
+
+        using parser::multiagent::FrozenDomain;
+        int a = fd->actionIndex( "MOVE-UP-SLOW" );
+        ASSERT_GE( a, 0 );
+        auto effects = FrozenDomain::part( fd->children, fd->nodes[fd->actions[a].eff].children );
+        unsigned increases = 0;
+        for ( unsigned c : effects ) {
+            if ( fd->nodes[c].kind != FrozenDomain::INCREASE ) continue;
+            const std::string& text = fd->increases[fd->nodes[c].symbol];
+            ASSERT_NE( text.find( "TRAVEL-SLOW" ), std::string::npos );
+            ASSERT_NE( text.find( "?1" ), std::string::npos );
+            ASSERT_NE( text.find( "?2" ), std::string::npos );
+            ++increases;
+        }
+        ASSERT_EQ( increases, 1u );
+    }
+
+    // a conditional effect without condition keeps its effect second
+    void whenFrozenTest() {
+        using namespace parser::pddl;
+        using parser::multiagent::FrozenDomain;
+        Domain dom;
+        dom.createType( "OBJ" );
+        dom.createPredicate( "P", StringVec( 1, "OBJ" ) );
+        dom.createPredicate( "Q", StringVec( 1, "OBJ" ) );
+        auto a = dom.createAction( "ACT", StringVec( 1, "OBJ" ) );
+        a->pre = std::make_shared< Ground >( dom.preds.get( "P" ), IntVec{ 0 } );
+        auto w = std::make_shared< When >();
+        w->cond = std::make_shared< Ground >( dom.preds.get( "Q" ), IntVec{ 0 } );
+        auto eff = std::make_shared< And >();
+        eff->add( w );
+        a->eff = eff;
+
+        auto fd = parser::multiagent::freeze( dom );
+        auto effects = FrozenDomain::part( fd->children, fd->nodes[fd->actions[0].eff].children );
+        ASSERT_EQ( effects.size(), 1u );
+        ASSERT_EQ( fd->nodes[effects[0]].kind, FrozenDomain::WHEN );
+        auto children = FrozenDomain::part( fd->children, fd->nodes[effects[0]].children );
+        ASSERT_EQ( children.size(), 2u );
+        ASSERT_EQ( children[0], FrozenDomain::none );
+        ASSERT_EQ( fd->nodes[children[1]].symbol, fd->predIndex( "Q" ) );
+        ASSERT_EQ( parser::multiagent::staticPredicates( *fd ), std::set< unsigned >{ unsigned( fd->predIndex( "P" ) ) } );
+        ASSERT_EQ( parser::multiagent::staticPredicates( dom ), parser::multiagent::staticPredicates( *fd ) );
+    }
+};
+
+class TypeTests : public testing::Test
+{
+public:
+
+    // subtype tests and objects of each type, before and after the network
+    // compiler adds the AGENT-COUNT type and its objects
+    void hierarchyTest() {
+        parser::multiagent::MultiagentDomain dom( "domains/multilog/Multilog_dom.pddl" );
+        parser::pddl::Instance ins( dom, "domains/multilog/Multilog_ins.pddl" );
+
+        parser::multiagent::TypeHierarchy h( dom );
+        int truck = dom.types.index( "TRUCK" ), agent = dom.types.index( "AGENT" ), airport = dom.types.index( "AIRPORT" );
+        ASSERT_TRUE( h.subtype( truck, agent ) );
+        ASSERT_TRUE( h.subtype( truck, truck ) );
+        ASSERT_FALSE( h.subtype( agent, truck ) );
+        ASSERT_FALSE( h.subtype( airport, agent ) );
+        for ( unsigned t = 0; t < dom.types.size(); ++t ) {
+            std::set< std::string > objects( h.objects( t ).begin(), h.objects( t ).end() ), expected;
+            for ( unsigned i = 0; i < dom.types[t]->noObjects(); ++i )
+                expected.insert( dom.types[t]->object( i ).first );
+            ASSERT_EQ( objects, expected );
+            for ( const auto & o : objects ) ASSERT_TRUE( h.isA( o, t ) );
+        }
+        ASSERT_TRUE( h.current() );
+
+        parser::multiagent::NetworkCompiler compiler( dom );
+        auto cd = compiler.compileDomain();
+        parser::multiagent::TypeHierarchy ch( *cd );
+        int count = cd->types.index( "AGENT-COUNT" );
+        ASSERT_GE( count, 0 );
+        ASSERT_EQ( ch.constants( count ).size(), 1u );
+        ASSERT_TRUE( ch.objects( count ).empty() );
+
+        compiler.compileInstance( *cd, ins );
+        ASSERT_FALSE( ch.current() );
+        ASSERT_TRUE( ch.update() );
+        ASSERT_EQ( ch.objects( count ).size(), cd->types[count]->noObjects() );
+        ASSERT_EQ( ch.objects( count ).size(), dom.types[agent]->noObjects() );
+        ASSERT_TRUE( ch.isA( "ACOUNT-1", count ) );
+        ASSERT_FALSE( ch.isA( "ACOUNT-1", agent ) );
+        ASSERT_FALSE( ch.update() );
+
+        // an object replaced by another one keeps the counts but not the hierarchy
+        auto & objects = cd->types[count]->objects;
+        ASSERT_FALSE( objects.empty() );
+        objects[0] = "ACOUNT-RENAMED";
+        ASSERT_FALSE( ch.current() );
+        ASSERT_TRUE( ch.update() );
+        ASSERT_TRUE( ch.isA( "ACOUNT-RENAMED", count ) );
+    }
+};
+
+class KeywordTests : public testing::Test
+{
+public:
+
+    // every keyword is found at its position and nothing else is found
+    void tablesTest() {
+        using parser::multiagent::ConcurrencyDomain;
+        static_assert( ConcurrencyDomain::conditionKeywords.find( "FORALL" ) == ConcurrencyDomain::FORALL );
+        static_assert( ConcurrencyDomain::conditionKeywords.find( "FORAL" ) == -1 );
+
+        std::vector<std::string> words = { "=", "AND", "EXISTS", "FORALL", "INCREASE", "NOT", "ONEOF", "OR", "WHEN" };
+        for ( unsigned i = 0; i < words.size(); ++i ) {
+            ASSERT_EQ( ConcurrencyDomain::conditionKeywords.find( words[i] ), int( i ) );
+            ASSERT_EQ( ConcurrencyDomain::conditionKeywords.find( words[i] + "S" ), -1 );
+        }
+        ASSERT_EQ( ConcurrencyDomain::conditionKeywords.find( "" ), -1 );
+        ASSERT_EQ( ConcurrencyDomain::conditionKeywords.find( "and" ), -1 );
+
+        using parser::multiagent::MultiagentDomain;
+        ASSERT_EQ( MultiagentDomain::requirementKeywords.find( "CONCURRENCY-NETWORK" ), MultiagentDomain::CONCURRENCY_NETWORK );
+        ASSERT_EQ( MultiagentDomain::blockKeywords.find( "ACTION" ), -1 );
+    }
+};
+
+class LazyTests : public testing::Test
+{
+public:
+
+    // a lazy domain has the signature of the domain, and the same domain once its conditions are parsed
+    void concurrencyLazyTest( const std::string& domain ) {
+        parser::multiagent::ConcurrencyDomain eager( domain ), lazy( domain, 1, true );
+        ASSERT_EQ( eager.actions.size(), lazy.actions.size() );
+        for ( unsigned i = 0; i < eager.actions.size(); ++i ) {
+            ASSERT_EQ( eager.actions[i]->name, lazy.actions[i]->name );
+            ASSERT_EQ( eager.actions[i]->params, lazy.actions[i]->params );
+            ASSERT_FALSE( lazy.actions[i]->pre );
+        }
+        ASSERT_TRUE( lazy.parsedAction( 0 )->pre );
+        ASSERT_FALSE( lazy.actions[1]->pre );
+
+        parser::multiagent::ConcurrencyCompiler compiler;
+        compiler.prepareDomain( eager );
+        compiler.prepareDomain( lazy );
+        ASSERT_TRUE( lazy.lazyBodies.empty() );
+
+        std::ostringstream e, l;
+        e << eager << *compiler.compileDomain( eager );
+        l << lazy << *compiler.compileDomain( lazy );
+        ASSERT_EQ( e.str(), l.str() );
+    }
+
+    void networkLazyTest( const std::string& domain ) {
+        parser::multiagent::MultiagentDomain eager( domain ), lazy( domain, 4, true );
+        ASSERT_EQ( eager.nodes.size(), lazy.nodes.size() );
+        ASSERT_FALSE( lazy.actions[0]->eff );
+
+        // steps that read conditions stop on unparsed actions, and only the
+        // signature of the domain can be frozen
+        ASSERT_EXIT( parser::multiagent::freeze( lazy ), testing::ExitedWithCode( 1 ), "" );
+        ASSERT_EQ( parser::multiagent::freeze( lazy, true )->actions[0].eff, -1 );
+        parser::multiagent::Simplifier simplifier;
+        ASSERT_EXIT( simplifier.simplify( lazy ), testing::ExitedWithCode( 1 ), "" );
+
+        lazy.parseBodies();
+        ASSERT_GE( parser::multiagent::freeze( lazy )->actions[0].eff, 0 );
+
+        std::ostringstream e, l;
+        e << eager << *parser::multiagent::NetworkCompiler( eager ).compileDomain();
+        l << lazy << *parser::multiagent::NetworkCompiler( lazy ).compileDomain();
+        ASSERT_EQ( e.str(), l.str() );
+    }
+};
+
+class LivenessTests : public testing::Test
+{
+public:
+
+    // the elimination never grows the task, keeps the goal predicates, and
+    // eliminating again from the reduced task changes nothing
+    void networkLivenessTest( const std::string& domain, const std::string& problem ) {
+        SCOPED_TRACE( problem );
+        parser::multiagent::MultiagentDomain dom( domain );
+        parser::pddl::Instance ins( dom, problem );
+        parser::multiagent::NetworkCompiler compiler( dom );
+        auto cd = compiler.compileDomain();
+        auto cins = compiler.compileInstance( *cd, ins );
+
+        parser::multiagent::Liveness first( *cd, *cins );
+        first.eliminate( *cd, *cins );
+        ASSERT_LE( first.actionsAfter, first.actionsBefore );
+        ASSERT_LE( first.predicatesAfter, first.predicatesBefore );
+        for (auto& g : cins->goal)
+            ASSERT_GE( cd->preds.index( g->name ), 0 );
+
+        std::ostringstream before, after;
+        before << *cd << *cins;
+        parser::multiagent::Liveness second( *cd, *cins );
+        second.eliminate( *cd, *cins );
+        after << *cd << *cins;
+        ASSERT_EQ( before.str(), after.str() );
+    }
+
+    // MAKE adds the goal and reads AT, which MOVE adds; NOISE only adds DEAD
+    // and MAKE also adds TOUCHED, which nothing reads, so NOISE, DEAD, TOUCHED,
+    // the effect of MAKE on TOUCHED and the initial DEAD fact are eliminated
+    void handBuiltLivenessTest() {
+        using namespace parser::pddl;
+        Domain cd;
+        cd.createType( "OBJ" );
+        for ( std::string p : { "AT", "DONE", "DEAD", "TOUCHED" } )
+            cd.createPredicate( p, StringVec( 1, "OBJ" ) );
+        auto atom = [&]( const std::string& p ) { return std::make_shared< Ground >( cd.preds.get( p ), IntVec{ 0 } ); };
+        auto action = [&]( const std::string& name, const StringVec& pre, const StringVec& eff ) {
+            auto a = cd.createAction( name, StringVec( 1, "OBJ" ) );
+            auto p = std::make_shared< And >(), e = std::make_shared< And >();
+            for ( const auto& s : pre ) p->add( atom( s ) );
+            for ( const auto& s : eff ) e->add( atom( s ) );
+            a->pre = p;
+            a->eff = e;
+        };
+        action( "MOVE", {}, { "AT" } );
+        action( "MAKE", { "AT" }, { "DONE", "TOUCHED" } );
+        action( "NOISE", { "AT" }, { "DEAD" } );
+
+        Instance cins( cd );
+        cins.addObject( "O1", "OBJ" );
+        cins.addInit( "AT", StringVec( 1, "O1" ) );
+        cins.addInit( "DEAD", StringVec( 1, "O1" ) );
+        cins.addGoal( "DONE", StringVec( 1, "O1" ) );
+
+        parser::multiagent::Liveness liveness( cd, cins );
+        ASSERT_EQ( liveness.live, std::set< std::string >( { "AT", "DONE" } ) );
+        liveness.eliminate( cd, cins );
+
+        ASSERT_EQ( cd.actions.size(), 2u );
+        ASSERT_GE( cd.actions.index( "MOVE" ), 0 );
+        ASSERT_GE( cd.actions.index( "MAKE" ), 0 );
+        ASSERT_LT( cd.actions.index( "NOISE" ), 0 );
+        ASSERT_EQ( cd.preds.size(), 2u );
+        ASSERT_LT( cd.preds.index( "DEAD" ), 0 );
+        ASSERT_LT( cd.preds.index( "TOUCHED" ), 0 );
+
+        auto eff = std::dynamic_pointer_cast< And >( cd.actions.get( "MAKE" )->eff );
+        ASSERT_TRUE( eff != nullptr );
+        ASSERT_EQ( eff->conds.size(), 1u );
+        ASSERT_EQ( std::dynamic_pointer_cast< Ground >( eff->conds[0] )->name, "DONE" );
+
+        ASSERT_EQ( cins.init.size(), 1u );
+        ASSERT_EQ( cins.init[0]->name, "AT" );
+        ASSERT_EQ( liveness.actionsBefore, 3u );
+        ASSERT_EQ( liveness.predicatesBefore, 4u );
+        ASSERT_EQ( liveness.initBefore, 2u );
+    }
+};
+
+class CacheTests : public testing::Test
+{
+public:
+
+    void cacheEntriesTest() {
+        parser::multiagent::DomainCache cache( "cache_test", 1 << 20 );
+        cache.clear();
+
+        std::string key = parser::multiagent::DomainCache::key( "domains/maze/domain/maze_dom_cal.pddl", "concurrency", "j=-1 o=0" );
+        std::string text;
+        ASSERT_FALSE( cache.lookup( key, text ) );
+        cache.store( key, "(define (domain maze))\n" );
+        ASSERT_TRUE( cache.lookup( key, text ) );
+        ASSERT_EQ( text, "(define (domain maze))\n" );
+
+        // other options or another domain must not hit the entry
+        ASSERT_NE( key, parser::multiagent::DomainCache::key( "domains/maze/domain/maze_dom_cal.pddl", "concurrency", "j=2 o=0" ) );
+        ASSERT_NE( key, parser::multiagent::DomainCache::key( "domains/maze/domain/maze_dom_cn.pddl", "concurrency", "j=-1 o=0" ) );
+
+        // entries beyond the size limit are evicted
+        parser::multiagent::DomainCache small( "cache_test", 16 );
+        small.store( "other", "(define (domain other))\n" );
+        ASSERT_FALSE( cache.lookup( key, text ) );
+
+        cache.clear();
+        ASSERT_FALSE( cache.lookup( "other", text ) );
+    }
+
+    // the instance compiled against the signature of the classical domain
+    // (what is done on a cache hit) equals the one compiled against the domain
+    void signatureInstanceTest() {
+        parser::multiagent::ConcurrencyCompiler compiler;
+        parser::multiagent::ConcurrencyDomain dom( "domains/maze/domain/maze_dom_cal.pddl" );
+        compiler.prepareDomain( dom );
+        parser::pddl::Instance ins( dom, "domains/maze/problems/maze5_4_1.pddl" );
+
+        std::ostringstream full, signature;
+        full << *compiler.compileInstance( *compiler.compileDomain( dom ), ins );
+        signature << *compiler.compileInstance( *compiler.compileSignature( dom ), ins );
+        ASSERT_EQ( full.str(), signature.str() );
+
+        parser::multiagent::MultiagentDomain ndom( "domains/maze/domain/maze_dom_cn.pddl" );
+        parser::pddl::Instance nins( ndom, "domains/maze/problems/maze5_4_1.pddl" );
+        parser::multiagent::NetworkCompiler ncompiler( ndom );
+
+        std::ostringstream nfull, nsignature;
+        nfull << *ncompiler.compileInstance( *ncompiler.compileDomain(), nins );
+        nsignature << *ncompiler.compileInstance( *ncompiler.compileSignature(), nins );
+        ASSERT_EQ( nfull.str(), nsignature.str() );
+    }
+};
+
+class ThreadingTests : public testing::Test
+{
+public:
+
+    // the classical domain does not depend on the number of threads compiling its actions
+    void concurrencyThreadsTest( const std::string& domain, bool agentOrder, int maxJointActionSize ) {
+        parser::multiagent::ConcurrencyCompiler serial( agentOrder, maxJointActionSize, 1 ), parallel( agentOrder, maxJointActionSize, 4 );
+        parser::multiagent::ConcurrencyDomain dom( domain );
+        serial.prepareDomain( dom );
+
+        std::ostringstream s, p;
+        s << *serial.compileDomain( dom );
+        p << *parallel.compileDomain( dom );
+        ASSERT_EQ( s.str(), p.str() );
+    }
+
+    // the domains parsed on one and on several threads print and compile the same
+    void concurrencyParseTest( const std::string& domain ) {
+        parser::multiagent::ConcurrencyCompiler compiler;
+        parser::multiagent::ConcurrencyDomain serial( domain ), parallel( domain, 4 );
+        ASSERT_TRUE( parallel.pendingConcurrencyGrounds.empty() );
+        compiler.prepareDomain( serial );
+        compiler.prepareDomain( parallel );
+
+        std::ostringstream s, p;
+        s << serial << *compiler.compileDomain( serial );
+        p << parallel << *compiler.compileDomain( parallel );
+        ASSERT_EQ( s.str(), p.str() );
+    }
+
+    void networkParseTest( const std::string& domain ) {
+        parser::multiagent::MultiagentDomain serial( domain ), parallel( domain, 4 );
+        ASSERT_EQ( serial.mf, parallel.mf );
+
+        std::ostringstream s, p;
+        s << serial << *parser::multiagent::NetworkCompiler( serial ).compileDomain();
+        p << parallel << *parser::multiagent::NetworkCompiler( parallel ).compileDomain();
+        ASSERT_EQ( s.str(), p.str() );
+    }
+};
+
 TEST_F(MultiagentTests, MultilogTest)
 {
     multiagentMultilogTest();
@@ -114,6 +1228,210 @@ TEST_F(ConcurrencyTests, TablemoverTest)
     concurrencyTablemoverTest();
 }
 
+TEST_F(ThreadingTests, TablemoverTest)
+{
+    concurrencyThreadsTest( "domains/tablemover/domain/table_domain1.pddl", false, -1 );
+    concurrencyThreadsTest( "domains/tablemover/domain/table_domain1.pddl", true, 2 );
+}
+
+TEST_F(ThreadingTests, WorkshopTest)
+{
+    concurrencyThreadsTest( "domains/workshop/domain/workshop_dom_cal.pddl", false, -1 );
+}
+
+TEST_F(ThreadingTests, ParseTest)
+{
+    concurrencyParseTest( "domains/tablemover/domain/table_domain8.pddl" );
+    concurrencyParseTest( "domains/workshop/domain/workshop_dom_cal.pddl" );
+    networkParseTest( "domains/maze/domain/maze_dom_cn.pddl" );
+    networkParseTest( "domains/workshop/domain/workshop_dom_cn.pddl" );
+}
+
+TEST_F(SimplifyTests, NetworkTest)
+{
+    networkSimplifyTest( "domains/maze/domain/maze_dom_cn.pddl" );
+    networkSimplifyTest( "domains/workshop/domain/workshop_dom_cn.pddl" );
+}
+
+TEST_F(SimplifyTests, HandBuiltTest)
+{
+    handBuiltSimplifyTest();
+}
+
+TEST_F(SimplifyTests, ConcurrencyTest)
+{
+    concurrencySimplifyTest( "domains/maze/domain/maze_dom_cal.pddl" );
+    concurrencySimplifyTest( "domains/workshop/domain/workshop_dom_cal.pddl" );
+    concurrencySimplifyTest( "domains/tablemover/domain/table_domain1.pddl" );
+}
+
+TEST_F(StaticTests, MazeTest)
+{
+    mazeStaticTest();
+}
+
+TEST_F(StaticTests, NetworkTest)
+{
+    networkStaticTest();
+}
+
+TEST_F(DecompositionTests, IndependentAgentsTest)
+{
+    independentAgentsTest();
+}
+
+TEST_F(DecompositionTests, ConcurrencyConstraintTest)
+{
+    concurrencyConstraintTest();
+}
+
+TEST_F(DecompositionTests, MazeTest)
+{
+    mazeTest();
+}
+
+TEST_F(DecompositionTests, MergeTest)
+{
+    mergeTest();
+}
+
+TEST_F(DeltaTests, NetworkTest)
+{
+    networkDeltaTest();
+}
+
+TEST_F(ProjectionTests, MultilogTest)
+{
+    multilogProjectionTest();
+}
+
+TEST_F(ProjectionTests, MazeConcurrencyTest)
+{
+    mazeConcurrencyProjectionTest();
+}
+
+TEST_F(CounterTests, NetworkTest)
+{
+    networkCounterTest();
+}
+
+TEST_F(SymmetryTests, NetworkTest)
+{
+    networkSymmetryTest();
+}
+
+TEST_F(StatisticsTests, NetworkTest)
+{
+    networkStatisticsTest( "domains/maze/domain/maze_dom_cn.pddl", "domains/maze/problems/maze5_4_1.pddl" );
+    networkStatisticsTest( "domains/workshop/domain/workshop_dom_cn.pddl", "domains/workshop/problems/workshop1_1.pddl" );
+}
+
+TEST_F(StatisticsTests, ConcurrencyTest)
+{
+    concurrencyStatisticsTest( "domains/tablemover/domain/table_domain1.pddl", "domains/tablemover/problems/table4_2_1.pddl" );
+    concurrencyConstraintTest();
+}
+
+TEST_F(FactTests, TableTest)
+{
+    tableTest();
+}
+
+TEST_F(FactTests, CopierTest)
+{
+    copierTest();
+}
+
+TEST_F(FactTests, StoreTest)
+{
+    storeTest();
+}
+
+TEST_F(FactTests, JoinTest)
+{
+    joinTest();
+}
+
+TEST_F(SharingTests, NetworkTest)
+{
+    networkSharingTest( "domains/tablemover/domain/Tablemover_dom_cn.pddl" );
+    networkSharingTest( "domains/workshop/domain/workshop_dom_cn.pddl" );
+}
+
+TEST_F(SharingTests, ConcurrencyTest)
+{
+    concurrencySharingTest( "domains/tablemover/domain/table_domain1.pddl" );
+    concurrencySharingTest( "domains/workshop/domain/workshop_dom_cal.pddl" );
+}
+
+TEST_F(SharingTests, ShiftTest)
+{
+    shiftSubclassTest();
+}
+
+TEST_F(FrozenTests, ConcurrencyTest)
+{
+    concurrencyFrozenTest();
+}
+
+TEST_F(FrozenTests, NetworkTest)
+{
+    networkFrozenTest();
+}
+
+TEST_F(FrozenTests, IncreaseTest)
+{
+    increaseFrozenTest();
+}
+
+TEST_F(FrozenTests, WhenTest)
+{
+    whenFrozenTest();
+}
+
+TEST_F(TypeTests, HierarchyTest)
+{
+    hierarchyTest();
+}
+
+TEST_F(KeywordTests, TablesTest)
+{
+    tablesTest();
+}
+
+TEST_F(LazyTests, ConcurrencyTest)
+{
+    concurrencyLazyTest( "domains/tablemover/domain/table_domain1.pddl" );
+    concurrencyLazyTest( "domains/workshop/domain/workshop_dom_cal.pddl" );
+}
+
+TEST_F(LazyTests, NetworkTest)
+{
+    networkLazyTest( "domains/maze/domain/maze_dom_cn.pddl" );
+    networkLazyTest( "domains/workshop/domain/workshop_dom_cn.pddl" );
+}
+
+TEST_F(LivenessTests, NetworkTest)
+{
+    networkLivenessTest( "domains/maze/domain/maze_dom_cn.pddl", "domains/maze/problems/maze5_4_1.pddl" );
+    networkLivenessTest( "domains/workshop/domain/workshop_dom_cn.pddl", "domains/workshop/problems/workshop1_1.pddl" );
+}
+
+TEST_F(LivenessTests, HandBuiltTest)
+{
+    handBuiltLivenessTest();
+}
+
+TEST_F(CacheTests, EntriesTest)
+{
+    cacheEntriesTest();
+}
+
+TEST_F(CacheTests, SignatureInstanceTest)
+{
+    signatureInstanceTest();
+}
+
 int main(int argc, char** argv)
 {
     testing::InitGoogleTest(&argc, argv);